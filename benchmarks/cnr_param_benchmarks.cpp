@@ -0,0 +1,526 @@
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/detail/os_file_functions.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+
+#include <cnr_param/cnr_param.h>
+#include <cnr_param/bind.h>
+#include <cnr_param/block.h>
+#include <cnr_param/utils/numbers.h>
+
+/**
+ * Benchmarks of the client API (has, get, set) over the key depth and the size of the values.
+ * The params are created by 'set' under a temporary CNR_PARAM_ROOT_DIRECTORY, removed at the end.
+ *
+ * JSON output, to compare two releases:
+ *   cnr_param_benchmarks --benchmark_out=results.json --benchmark_out_format=json
+ */
+
+struct ComplexType
+{
+  std::string name;
+  double value;
+};
+
+namespace cnr { namespace param {
+  template<> bool get_map(const node_t& node, ComplexType& ret, std::stringstream& what)
+  {
+    try
+    {
+      if(node["name"] && node["value"])
+      {
+        ret.name = node["name"].as<std::string>();
+        ret.value = node["value"].as<double>();
+        return true;
+      }
+    }
+    catch (std::exception& e)
+    {
+      what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": " << e.what() << std::endl;
+    }
+    return false;
+  }
+}}
+
+struct BoundType
+{
+  std::string name;
+  double value;
+};
+CNR_PARAM_BIND(BoundType, CNR_PARAM_FIELD(name), CNR_PARAM_FIELD(value))
+
+struct PodType
+{
+  double gains[6][6];
+  std::int32_t mode;
+};
+
+namespace
+{
+
+const std::vector<int64_t> depths = {1, 4, 16};
+const std::vector<int64_t> sizes = {16, 256, 4096};
+const std::vector<int64_t> parsers = {0, 1, 2, 3};  // cnr::param::utils::number_parser_t
+const std::vector<int64_t> bulk_sizes = {4096, 65536, 1048576};
+
+std::string key(const std::string& leaf, int64_t depth)
+{
+  std::string ns = "/bench";
+  for(int64_t i = 1; i < depth; i++)
+  {
+    ns += "/l" + std::to_string(i);
+  }
+  return ns + "/" + leaf;
+}
+
+std::string key(const std::string& leaf, int64_t depth, int64_t size)
+{
+  return key(leaf + "_" + std::to_string(size), depth);
+}
+
+bool populate()
+{
+  std::string what;
+  bool ok = true;
+  for(auto d : depths)
+  {
+    ok &= cnr::param::set(key("double", d), 3.14, what);
+    ok &= cnr::param::set(key("int", d), 42, what);
+    ok &= cnr::param::set(key("string", d), std::string("/joint_states"), what);
+  }
+  for(auto n : sizes)
+  {
+    ok &= cnr::param::set(key("vector", 1, n), std::vector<double>(n, 1.0), what);
+    Eigen::MatrixXd m = Eigen::MatrixXd::Random(n, 6);
+    ok &= cnr::param::set(key("matrix", 1, n), m, what);
+    ok &= cnr::param::set(key("matrix_text", 1, n), std::vector<std::vector<double>>(n, std::vector<double>(6, 1.0)), what);
+  }
+  for(auto n : bulk_sizes)
+  {
+    std::vector<double> v(static_cast<std::size_t>(n));
+    for(std::size_t i = 0; i < v.size(); i++)
+    {
+      v[i] = std::sin(double(i)) * 100.0;
+    }
+    ok &= cnr::param::set(key("numbers", 1, n), v, what);
+  }
+  ok &= cnr::param::set(key("array", 1), std::vector<double>(16, 1.0), what);
+  ok &= cnr::param::set(key("array6x6", 1), std::vector<std::vector<double>>(6, std::vector<double>(6, 1.0)), what);
+  ok &= cnr::param::set(key("fixed", 1), Eigen::Matrix<double, 6, 6>::Identity().eval(), what);
+
+  YAML::Node complex;
+  for(int i = 0; i < 16; i++)
+  {
+    YAML::Node item;
+    item["name"] = "item_" + std::to_string(i);
+    item["value"] = double(i);
+    complex.push_back(item);
+  }
+  ok &= cnr::param::set(key("complex", 1), complex, what);
+  if(!ok)
+  {
+    std::cerr << "Error in creating the params: " << what << std::endl;
+  }
+  return ok;
+}
+
+YAML::Node items(int64_t n)
+{
+  YAML::Node node;
+  for(int64_t i = 0; i < n; i++)
+  {
+    YAML::Node item;
+    item["name"] = "item_" + std::to_string(i);
+    item["value"] = double(i);
+    node.push_back(item);
+  }
+  return node;
+}
+
+template<typename T>
+void extract(benchmark::State& state)
+{
+  const YAML::Node node = items(state.range(0));
+  for(auto _ : state)
+  {
+    auto value = cnr::param::try_extract<std::vector<T>>(node);
+    if(!value)
+    {
+      state.SkipWithError(value.error().message().c_str());
+      break;
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename M>
+void extractMap(benchmark::State& state)
+{
+  YAML::Node node;
+  for(int64_t i = 0; i < state.range(0); i++)
+  {
+    node["joint_" + std::to_string(i)] = std::vector<double>{-1.0, 1.0};
+  }
+  for(auto _ : state)
+  {
+    auto value = cnr::param::try_extract<M>(node);
+    if(!value)
+    {
+      state.SkipWithError(value.error().message().c_str());
+      break;
+    }
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename T>
+void get(benchmark::State& state, const std::string& k)
+{
+  std::string what;
+  T value;
+  for(auto _ : state)
+  {
+    if(!cnr::param::get(k, value, what))
+    {
+      state.SkipWithError(what.c_str());
+      break;
+    }
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+}  // namespace
+
+static void BM_Has(benchmark::State& state)
+{
+  std::string what;
+  const std::string k = key("double", state.range(0));
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(cnr::param::has(k, what));
+  }
+}
+BENCHMARK(BM_Has)->ArgName("depth")->ArgsProduct({depths});
+
+static void BM_GetDouble(benchmark::State& state)
+{
+  get<double>(state, key("double", state.range(0)));
+}
+BENCHMARK(BM_GetDouble)->ArgName("depth")->ArgsProduct({depths});
+
+static void BM_GetInt(benchmark::State& state)
+{
+  get<int>(state, key("int", state.range(0)));
+}
+BENCHMARK(BM_GetInt)->ArgName("depth")->ArgsProduct({depths});
+
+static void BM_GetString(benchmark::State& state)
+{
+  get<std::string>(state, key("string", state.range(0)));
+}
+BENCHMARK(BM_GetString)->ArgName("depth")->ArgsProduct({depths});
+
+static void BM_GetVector(benchmark::State& state)
+{
+  get<std::vector<double>>(state, key("vector", 1, state.range(0)));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_GetVector)->ArgName("size")->ArgsProduct({sizes});
+
+static void BM_GetArray(benchmark::State& state)
+{
+  get<std::array<double, 16>>(state, key("array", 1));
+}
+BENCHMARK(BM_GetArray);
+
+static void BM_GetArray6x6(benchmark::State& state)
+{
+  get<std::array<std::array<double, 6>, 6>>(state, key("array6x6", 1));
+}
+BENCHMARK(BM_GetArray6x6);
+
+static void BM_GetPod(benchmark::State& state)
+{
+  std::string what;
+  cnr::param::param_error err;
+  const std::string k = key("pod", 1);
+  PodType value{};
+  if(!cnr::param::set_pod(k, value, what))
+  {
+    state.SkipWithError(what.c_str());
+    return;
+  }
+  for(auto _ : state)
+  {
+    if(!cnr::param::get_pod(k, value, err))
+    {
+      state.SkipWithError(err.message().c_str());
+      break;
+    }
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_GetPod);
+
+static void BM_GetBlock(benchmark::State& state)
+{
+  std::string what;
+  cnr::param::Block<PodType> block;
+  PodType value{};
+  if(!block.open(key("block", 1), what, true) || !block.set(value, what))
+  {
+    state.SkipWithError(what.c_str());
+    return;
+  }
+  for(auto _ : state)
+  {
+    block.get(value);
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_GetBlock);
+
+static void BM_GetEigenFixed(benchmark::State& state)
+{
+  get<Eigen::Matrix<double, 6, 6>>(state, key("fixed", 1));
+}
+BENCHMARK(BM_GetEigenFixed);
+
+static void BM_GetEigenDynamic(benchmark::State& state)
+{
+  get<Eigen::MatrixXd>(state, key("matrix", 1, state.range(0)));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 6 * sizeof(double));
+}
+BENCHMARK(BM_GetEigenDynamic)->ArgName("rows")->ArgsProduct({sizes});
+
+static void BM_GetEigenFromText(benchmark::State& state)
+{
+  get<Eigen::MatrixXd>(state, key("matrix_text", 1, state.range(0)));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 6 * sizeof(double));
+}
+BENCHMARK(BM_GetEigenFromText)->ArgName("rows")->ArgsProduct({sizes});
+
+static void BM_GetNestedVector(benchmark::State& state)
+{
+  get<std::vector<std::vector<double>>>(state, key("matrix_text", 1, state.range(0)));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 6 * sizeof(double));
+}
+BENCHMARK(BM_GetNestedVector)->ArgName("rows")->ArgsProduct({sizes});
+
+static void BM_GetTable(benchmark::State& state)
+{
+  get<cnr::param::Matrix<double>>(state, key("matrix_text", 1, state.range(0)));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 6 * sizeof(double));
+}
+BENCHMARK(BM_GetTable)->ArgName("rows")->ArgsProduct({sizes});
+
+// the same sequence converted by yaml-cpp (parser 0) and by the bulk parser (portable, sse, avx2)
+static void BM_GetNumbers(benchmark::State& state)
+{
+  const auto parser = static_cast<cnr::param::utils::number_parser_t>(state.range(0));
+  const auto in_use = cnr::param::utils::numberParser();
+  if(!cnr::param::utils::setNumberParser(parser))
+  {
+    state.SkipWithError("The parser is not supported by the CPU");
+    return;
+  }
+  state.SetLabel(cnr::param::utils::to_string(parser));
+  get<std::vector<double>>(state, key("numbers", 1, state.range(1)));
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+  cnr::param::utils::setNumberParser(in_use);
+}
+BENCHMARK(BM_GetNumbers)->ArgNames({"parser", "size"})->ArgsProduct({parsers, bulk_sizes})->Unit(benchmark::kMicrosecond);
+
+static void BM_GetComplexType(benchmark::State& state)
+{
+  get<std::vector<ComplexType>>(state, key("complex", 1));
+}
+BENCHMARK(BM_GetComplexType);
+
+// decoding of the structs from the node, by the 'get_map' written by hand and by the binding
+static void BM_ExtractComplexType(benchmark::State& state)
+{
+  extract<ComplexType>(state);
+}
+BENCHMARK(BM_ExtractComplexType)->ArgName("size")->ArgsProduct({sizes});
+
+static void BM_ExtractBoundType(benchmark::State& state)
+{
+  extract<BoundType>(state);
+}
+BENCHMARK(BM_ExtractBoundType)->ArgName("size")->ArgsProduct({sizes});
+
+static void BM_ExtractMap(benchmark::State& state)
+{
+  extractMap<std::map<std::string, std::vector<double>>>(state);
+}
+BENCHMARK(BM_ExtractMap)->ArgName("size")->ArgsProduct({sizes});
+
+static void BM_ExtractUnorderedMap(benchmark::State& state)
+{
+  extractMap<std::unordered_map<std::string, std::vector<double>>>(state);
+}
+BENCHMARK(BM_ExtractUnorderedMap)->ArgName("size")->ArgsProduct({sizes});
+
+static void BM_ExtractFlatMap(benchmark::State& state)
+{
+  extractMap<cnr::param::flat_map<std::string, std::vector<double>>>(state);
+}
+BENCHMARK(BM_ExtractFlatMap)->ArgName("size")->ArgsProduct({sizes});
+
+static void BM_GetDefault(benchmark::State& state)
+{
+  // range(0): 1 if the param exists, 0 if the default value is superimposed
+  std::string what;
+  const std::string k = state.range(0) ? key("double", 1) : key("missing", 1);
+  double value = 0;
+  for(auto _ : state)
+  {
+    what.clear();
+    benchmark::DoNotOptimize(cnr::param::get(k, value, what, 1.0));
+  }
+}
+BENCHMARK(BM_GetDefault)->ArgName("exists")->Arg(0)->Arg(1);
+
+static void BM_GetFailure(benchmark::State& state)
+{
+  // range(0): 0 missing param, 1 mismatch of the type; the message is formatted in 'what'
+  std::string what;
+  const std::string k = state.range(0) ? key("string", 1) : key("missing", 1);
+  double value = 0;
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(cnr::param::get(k, value, what));
+  }
+}
+BENCHMARK(BM_GetFailure)->ArgName("mismatch")->Arg(0)->Arg(1);
+
+static void BM_TryGet(benchmark::State& state)
+{
+  // range(0): 0 missing param, 1 mismatch of the type, 2 success; the error is only recorded
+  const std::string k = state.range(0) == 2 ? key("double", 1) : state.range(0) ? key("string", 1) : key("missing", 1);
+  for(auto _ : state)
+  {
+    benchmark::DoNotOptimize(cnr::param::try_get<double>(k));
+  }
+}
+BENCHMARK(BM_TryGet)->ArgName("case")->Arg(0)->Arg(1)->Arg(2);
+
+static void BM_SetDouble(benchmark::State& state)
+{
+  std::string what;
+  const std::string k = key("set_double", state.range(0));
+  double value = 0;
+  for(auto _ : state)
+  {
+    if(!cnr::param::set(k, value, what))
+    {
+      state.SkipWithError(what.c_str());
+      break;
+    }
+    value += 1.0;
+  }
+}
+BENCHMARK(BM_SetDouble)->ArgName("depth")->ArgsProduct({depths});
+
+static void BM_SetVector(benchmark::State& state)
+{
+  std::string what;
+  const std::string k = key("set_vector", 1, state.range(0));
+  std::vector<double> value(state.range(0), 1.0);
+  for(auto _ : state)
+  {
+    if(!cnr::param::set(k, value, what))
+    {
+      state.SkipWithError(what.c_str());
+      break;
+    }
+    value[0] += 1.0;
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+BENCHMARK(BM_SetVector)->ArgName("size")->ArgsProduct({sizes});
+
+static void BM_SetEigen(benchmark::State& state)
+{
+  std::string what;
+  const std::string k = key("set_matrix", 1, state.range(0));
+  Eigen::MatrixXd value = Eigen::MatrixXd::Random(state.range(0), 6);
+  for(auto _ : state)
+  {
+    if(!cnr::param::set(k, value, what))
+    {
+      state.SkipWithError(what.c_str());
+      break;
+    }
+    value(0, 0) += 1.0;
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 6 * sizeof(double));
+}
+BENCHMARK(BM_SetEigen)->ArgName("rows")->ArgsProduct({sizes});
+
+static void BM_SetPod(benchmark::State& state)
+{
+  std::string what;
+  const std::string k = key("set_pod", 1);
+  PodType value{};
+  for(auto _ : state)
+  {
+    if(!cnr::param::set_pod(k, value, what))
+    {
+      state.SkipWithError(what.c_str());
+      break;
+    }
+    value.gains[0][0] += 1.0;
+  }
+}
+BENCHMARK(BM_SetPod);
+
+static void BM_SetString(benchmark::State& state)
+{
+  std::string what;
+  const std::string k = key("set_string", state.range(0));
+  const std::string value = "/joint_states";
+  for(auto _ : state)
+  {
+    if(!cnr::param::set(k, value, what))
+    {
+      state.SkipWithError(what.c_str());
+      break;
+    }
+  }
+}
+BENCHMARK(BM_SetString)->ArgName("depth")->ArgsProduct({depths});
+
+int main(int argc, char** argv)
+{
+  boost::filesystem::path root = boost::filesystem::path(boost::interprocess::ipcdetail::get_temporary_path()) 
+    / ("cnr_param_benchmarks." + std::to_string(boost::interprocess::ipcdetail::get_current_process_id()));
+  boost::filesystem::create_directories(root);
+  setenv("CNR_PARAM_ROOT_DIRECTORY", root.string().c_str(), 1);
+
+  int ret = 1;
+  if(populate())
+  {
+    benchmark::Initialize(&argc, argv);
+    if(!benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+      benchmark::RunSpecifiedBenchmarks();
+      benchmark::Shutdown();
+      ret = 0;
+    }
+  }
+  boost::filesystem::remove_all(root);
+  return ret;
+}
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <cnr_param/utils/string.h>
+
+#include "yaml_generator.h"
+
+namespace po = boost::program_options;
+
+/**
+ * Generator of synthetic configurations, to load with cnr_param_server:
+ *   cnr_param_generate_yaml --keys 100000 --depth 5 --fanout 10 --output /tmp/config
+ *   cnr_param_server -p /tmp/config_0.yaml -p /tmp/config_1.yaml
+ */
+int main(int argc, char* argv[])
+{
+  cnr::param::benchmarks::yaml_tree_t tree;
+  std::string types;
+  std::string output;
+
+  po::options_description options("Synthetic YAML configuration", 160);
+  options.add_options()
+    ("help,h", "produce help message")
+    ("keys,k", po::value<std::size_t>(&tree.keys)->default_value(tree.keys), "number of keys (leaves) of the tree")
+    ("depth,d", po::value<std::size_t>(&tree.depth)->default_value(tree.depth),
+      "levels of the tree, the keys included")
+    ("fanout,f", po::value<std::size_t>(&tree.fanout)->default_value(tree.fanout), "children of each namespace")
+    ("types,t", po::value<std::string>(&types)->default_value("double,int,bool,string,vector,matrix"),
+      "comma separated types of the leaves, picked at random: double, int, bool, string, vector, matrix")
+    ("duplication,r", po::value<double>(&tree.duplication)->default_value(tree.duplication),
+      "fraction of the keys overridden by each file after the first one")
+    ("files,n", po::value<std::size_t>(&tree.files)->default_value(tree.files), "number of files")
+    ("seed,s", po::value<std::uint32_t>(&tree.seed)->default_value(tree.seed), "seed of the generator")
+    ("output,o", po::value<std::string>(&output)->default_value("config"),
+      "prefix of the files, written as '<prefix>_<i>.yaml'");
+
+  try
+  {
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, options), vm);
+    po::notify(vm);
+    if(vm.count("help"))
+    {
+      std::cout << options << std::endl;
+      return 0;
+    }
+  }
+  catch(std::exception& e)
+  {
+    std::cerr << e.what() << std::endl << options << std::endl;
+    return 1;
+  }
+
+  tree.types = cnr::param::utils::tokenize(types, ",");
+  if(tree.types.empty())
+  {
+    tree.types = {types};
+  }
+
+  std::string what;
+  std::vector<std::string> files;
+  if(!cnr::param::benchmarks::generate_yaml(tree, output, files, what))
+  {
+    std::cerr << what << std::endl;
+    return 1;
+  }
+  for(const auto& fn : files)
+  {
+    std::cout << fn << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,270 @@
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include <cnr_param/utils/string.h>
+#include <cnr_param/utils/yaml.h>
+#include <cnr_param_server/utils/yaml_manager.h>
+
+#include "yaml_generator.h"
+
+namespace po = boost::program_options;
+
+/**
+ * Startup of the server over synthetic configurations of growing size. The phases are the same of cnr_param_server:
+ *  - parse: the files are loaded by yaml-cpp
+ *  - merge: the documents are merged in a single tree, as YAMLParser does
+ *  - publish: the tree is streamed in the entries under the root directory by YAMLStreamer
+ *
+ * Each size runs in a forked process, so that the peak RSS of a size is not inflated by the previous ones.
+ *
+ *   cnr_param_server_benchmark --keys 1000 10000 100000 1000000 --out server.json
+ */
+
+namespace
+{
+
+struct phase_result_t
+{
+  char phase[16];
+  std::size_t keys;
+  double seconds;
+  long peak_rss_kb;
+  std::size_t files;
+  std::size_t mapped_bytes;
+};
+
+long peak_rss_kb()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+void scan(const boost::filesystem::path& root, std::size_t& files, std::size_t& bytes)
+{
+  files = 0;
+  bytes = 0;
+  boost::system::error_code ec;
+  for(boost::filesystem::recursive_directory_iterator it(root, ec), end; it != end; it.increment(ec))
+  {
+    if(boost::filesystem::is_regular_file(it->path(), ec))
+    {
+      files++;
+      bytes += boost::filesystem::file_size(it->path(), ec);
+    }
+  }
+}
+
+/**
+ * The child process: it generates the configuration, it runs the phases and it writes the results in the pipe
+ */
+int run(const cnr::param::benchmarks::yaml_tree_t& tree, const boost::filesystem::path& dir, int fd)
+{
+  // The server prints the published entries in some builds, it must not pollute the report
+  int null_fd = open("/dev/null", O_WRONLY);
+  if(null_fd >= 0)
+  {
+    std::cout.flush();
+    dup2(null_fd, STDOUT_FILENO);
+    close(null_fd);
+  }
+
+  const boost::filesystem::path config = dir / "config";
+  const boost::filesystem::path params = dir / "params";
+  boost::filesystem::create_directories(config);
+  boost::filesystem::create_directories(params);
+
+  std::string what;
+  std::vector<std::string> files;
+  if(!cnr::param::benchmarks::generate_yaml(tree, (config / "config").string(), files, what))
+  {
+    std::cerr << what << std::endl;
+    return 1;
+  }
+
+  auto report = [&](const char* phase, const std::chrono::steady_clock::time_point& start)
+  {
+    phase_result_t r;
+    std::memset(&r, 0, sizeof(r));
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::strncpy(r.phase, phase, sizeof(r.phase) - 1);
+    r.keys = tree.keys;
+    r.peak_rss_kb = peak_rss_kb();
+    scan(params, r.files, r.mapped_bytes);
+    return write(fd, &r, sizeof(r)) == sizeof(r);
+  };
+
+  try
+  {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<YAML::Node> documents;
+    for(const auto& fn : files)
+    {
+      auto nodes = YAML::LoadAllFromFile(fn);
+      documents.insert(documents.end(), nodes.begin(), nodes.end());
+    }
+    if(!report("parse", start))
+    {
+      return 1;
+    }
+
+    start = std::chrono::steady_clock::now();
+    YAML::Node root(YAML::NodeType::Map);
+    for(const auto& node : documents)
+    {
+      root = cnr::param::utils::merge_nodes(root, cnr::param::utils::init_tree({}, node));
+    }
+    documents.clear();
+    if(!report("merge", start))
+    {
+      return 1;
+    }
+
+    start = std::chrono::steady_clock::now();
+    YAMLStreamer streamer(root, params.string());
+    if(!report("publish", start))
+    {
+      return 1;
+    }
+  }
+  catch(std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  cnr::param::benchmarks::yaml_tree_t tree;
+  std::vector<std::size_t> keys;
+  std::string types;
+  std::string out;
+  bool keep = false;
+
+  po::options_description options("Startup of cnr_param_server over synthetic configurations", 160);
+  options.add_options()
+    ("help,h", "produce help message")
+    ("keys,k", po::value<std::vector<std::size_t>>(&keys)->multitoken()->default_value({1000, 10000}, "1000 10000"), "number of keys of each run")
+    ("depth,d", po::value<std::size_t>(&tree.depth)->default_value(tree.depth),
+      "levels of the tree, the keys included")
+    ("fanout,f", po::value<std::size_t>(&tree.fanout)->default_value(tree.fanout), "children of each namespace")
+    ("types,t", po::value<std::string>(&types)->default_value("double,int,bool,string,vector,matrix"),
+      "comma separated types of the leaves")
+    ("duplication,r", po::value<double>(&tree.duplication)->default_value(tree.duplication),
+      "fraction of the keys overridden by each file after the first one")
+    ("files,n", po::value<std::size_t>(&tree.files)->default_value(tree.files), "number of files")
+    ("seed,s", po::value<std::uint32_t>(&tree.seed)->default_value(tree.seed), "seed of the generator")
+    ("out,o", po::value<std::string>(&out), "JSON file of the results")
+    ("keep", po::bool_switch(&keep), "do not remove the generated files and the published params");
+
+  try
+  {
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, options), vm);
+    po::notify(vm);
+    if(vm.count("help"))
+    {
+      std::cout << options << std::endl;
+      return 0;
+    }
+  }
+  catch(std::exception& e)
+  {
+    std::cerr << e.what() << std::endl << options << std::endl;
+    return 1;
+  }
+  tree.types = cnr::param::utils::tokenize(types, ",");
+  if(tree.types.empty())
+  {
+    tree.types = {types};
+  }
+
+  std::cout << std::left << std::setw(10) << "keys" << std::setw(10) << "phase" << std::right
+            << std::setw(12) << "time [s]" << std::setw(16) << "peak RSS [KiB]" << std::setw(12) << "files"
+            << std::setw(18) << "mapped [bytes]" << std::endl;
+
+  std::vector<phase_result_t> results;
+  int ret = 0;
+  for(const auto& k : keys)
+  {
+    tree.keys = k;
+    const boost::filesystem::path dir = boost::filesystem::temp_directory_path()
+      / ("cnr_param_server_benchmark." + std::to_string(getpid()) + "." + std::to_string(k));
+
+    int fds[2];
+    if(pipe(fds) != 0)
+    {
+      std::cerr << "Error in creating the pipe: " << std::strerror(errno) << std::endl;
+      return 1;
+    }
+
+    pid_t pid = fork();
+    if(pid == 0)
+    {
+      close(fds[0]);
+      int rc = run(tree, dir, fds[1]);
+      close(fds[1]);
+      _exit(rc);
+    }
+    close(fds[1]);
+
+    phase_result_t r;
+    while(pid > 0 && read(fds[0], &r, sizeof(r)) == sizeof(r))
+    {
+      std::cout << std::left << std::setw(10) << r.keys << std::setw(10) << r.phase << std::right << std::fixed
+                << std::setprecision(4) << std::setw(12) << r.seconds << std::setw(16) << r.peak_rss_kb
+                << std::setw(12) << r.files << std::setw(18) << r.mapped_bytes << std::endl;
+      results.push_back(r);
+    }
+    close(fds[0]);
+
+    int status = 0;
+    if(pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+      std::cerr << "The run with " << k << " keys failed" << std::endl;
+      ret = 1;
+    }
+    if(!keep)
+    {
+      boost::system::error_code ec;
+      boost::filesystem::remove_all(dir, ec);
+    }
+  }
+
+  if(!out.empty())
+  {
+    std::ofstream json(out);
+    json << "{\n  \"depth\": " << tree.depth << ",\n  \"fanout\": " << tree.fanout << ",\n  \"duplication\": "
+         << tree.duplication << ",\n  \"files\": " << tree.files << ",\n  \"seed\": " << tree.seed
+         << ",\n  \"results\": [\n";
+    for(std::size_t i = 0; i < results.size(); i++)
+    {
+      const auto& r = results[i];
+      json << "    {\"keys\": " << r.keys << ", \"phase\": \"" << r.phase << "\", \"seconds\": " << r.seconds
+           << ", \"peak_rss_kb\": " << r.peak_rss_kb << ", \"files\": " << r.files << ", \"mapped_bytes\": "
+           << r.mapped_bytes << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+  }
+  return ret;
+}
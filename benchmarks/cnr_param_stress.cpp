@@ -0,0 +1,480 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <cnr_param/cnr_param.h>
+#include <cnr_param/block.h>
+
+namespace po = boost::program_options;
+
+/**
+ * Stress of the concurrent access to the same keys: N readers call get() and M writers call set() in different
+ * processes, under a temporary CNR_PARAM_ROOT_DIRECTORY.
+ *
+ * Each value is a vector whose last element is the checksum of the others, so a reader detects the torn reads, i.e.,
+ * a value mixing two writes. The failed reads (get() returning false on an existing key) are counted apart.
+ * The exit code is not zero if any torn or failed read is detected, so the harness validates the publication scheme.
+ *
+ *   cnr_param_stress --readers 4 --writers 1 --keys 16 --size 64 --duration 5 --out stress.json
+ *
+ * With '--block', the values are parameter blocks (see cnr/param/block.h) of 'block_size' elements: the readers copy
+ * the front buffer and the writers publish as fast as they can, to measure the latency of the real-time readers
+ * under the saturation of the writers.
+ */
+
+namespace
+{
+
+// Log-linear histogram of the latencies in ns: 64 sub-buckets for each power of 2, i.e., less than 2% of error
+constexpr std::size_t sub_buckets = 64;
+constexpr std::size_t buckets = 64 * sub_buckets;
+
+std::size_t bucket(std::uint64_t ns)
+{
+  if(ns < sub_buckets)
+  {
+    return static_cast<std::size_t>(ns);
+  }
+  const std::size_t e = 63 - static_cast<std::size_t>(__builtin_clzll(ns));  // ns in [2^e, 2^(e+1))
+  const std::size_t s = static_cast<std::size_t>(ns >> (e - 6)) - sub_buckets;
+  return std::min(buckets - 1, (e - 5) * sub_buckets + s);
+}
+
+std::uint64_t bucket_value(std::size_t b)
+{
+  if(b < sub_buckets)
+  {
+    return b;
+  }
+  const std::size_t e = b / sub_buckets + 5;
+  const std::size_t s = b % sub_buckets;
+  return static_cast<std::uint64_t>(sub_buckets + s) << (e - 6);
+}
+
+struct process_result_t
+{
+  std::uint64_t ops;
+  std::uint64_t failed;
+  std::uint64_t torn;
+  double seconds;
+  std::uint64_t histogram[buckets];
+};
+
+double checksum(const std::vector<double>& v)
+{
+  double c = 0.0;
+  for(std::size_t i = 0; i + 1 < v.size(); i++)
+  {
+    c += v[i] * double(i + 1);
+  }
+  return c;
+}
+
+void fill(std::vector<double>& v, std::uint64_t writer, std::uint64_t seq)
+{
+  for(std::size_t i = 0; i + 1 < v.size(); i++)
+  {
+    v[i] = double((seq * 31 + writer * 7 + i) % 1000003);
+  }
+  v.back() = checksum(v);
+}
+
+constexpr std::size_t block_size = 64;
+
+struct block_value_t
+{
+  double v[block_size];
+};
+
+double checksum(const block_value_t& b)
+{
+  double c = 0.0;
+  for(std::size_t i = 0; i + 1 < block_size; i++)
+  {
+    c += b.v[i] * double(i + 1);
+  }
+  return c;
+}
+
+void fill(block_value_t& b, std::uint64_t writer, std::uint64_t seq)
+{
+  for(std::size_t i = 0; i + 1 < block_size; i++)
+  {
+    b.v[i] = double((seq * 31 + writer * 7 + i) % 1000003);
+  }
+  b.v[block_size - 1] = checksum(b);
+}
+
+std::string key(std::size_t k)
+{
+  return "/stress/ns" + std::to_string(k % 4) + "/key_" + std::to_string(k);
+}
+
+/**
+ * @brief The blocks of the keys, opened before the loop as a real-time reader does
+ */
+bool open_blocks(std::size_t keys, bool create, std::vector<std::unique_ptr<cnr::param::Block<block_value_t>>>& blocks)
+{
+  std::string what;
+  blocks.clear();
+  for(std::size_t k = 0; k < keys; k++)
+  {
+    blocks.emplace_back(new cnr::param::Block<block_value_t>());
+    if(!blocks.back()->open(key(k), what, create))
+    {
+      std::cerr << "Error in opening the block '" << key(k) << "': " << what << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+void block_reader(std::size_t keys, double duration, process_result_t& r)
+{
+  std::vector<std::unique_ptr<cnr::param::Block<block_value_t>>> blocks;
+  if(!open_blocks(keys, false, blocks))
+  {
+    r.failed++;
+    return;
+  }
+  block_value_t b;
+  const auto start = std::chrono::steady_clock::now();
+  const auto stop = start + std::chrono::duration<double>(duration);
+  std::size_t k = 0;
+  for(auto now = start; now < stop; k++)
+  {
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool ok = blocks[k % keys]->get(b);
+    now = std::chrono::steady_clock::now();
+    r.histogram[bucket(std::chrono::duration_cast<std::chrono::nanoseconds>(now - t0).count())]++;
+    r.ops++;
+    if(!ok)
+    {
+      r.failed++;
+    }
+    else if(b.v[block_size - 1] != checksum(b))
+    {
+      r.torn++;
+    }
+  }
+  r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void block_writer(std::size_t id, std::size_t keys, double duration, process_result_t& r)
+{
+  std::vector<std::unique_ptr<cnr::param::Block<block_value_t>>> blocks;
+  if(!open_blocks(keys, false, blocks))
+  {
+    r.failed++;
+    return;
+  }
+  block_value_t b;
+  std::string what;
+  const auto start = std::chrono::steady_clock::now();
+  const auto stop = start + std::chrono::duration<double>(duration);
+  std::uint64_t seq = 0;
+  for(auto now = start; now < stop; seq++)
+  {
+    fill(b, id, seq);
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool ok = blocks[(seq + id) % keys]->set(b, what);
+    now = std::chrono::steady_clock::now();
+    r.histogram[bucket(std::chrono::duration_cast<std::chrono::nanoseconds>(now - t0).count())]++;
+    r.ops++;
+    r.failed += ok ? 0 : 1;
+  }
+  r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void reader(std::size_t keys, double duration, process_result_t& r)
+{
+  std::vector<double> v;
+  std::string what;
+  const auto start = std::chrono::steady_clock::now();
+  const auto stop = start + std::chrono::duration<double>(duration);
+  std::size_t k = 0;
+  for(auto now = start; now < stop; k++)
+  {
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool ok = cnr::param::get(key(k % keys), v, what);
+    now = std::chrono::steady_clock::now();
+    r.histogram[bucket(std::chrono::duration_cast<std::chrono::nanoseconds>(now - t0).count())]++;
+    r.ops++;
+    if(!ok)
+    {
+      r.failed++;
+    }
+    else if(v.size() < 2 || v.back() != checksum(v))
+    {
+      r.torn++;
+    }
+  }
+  r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void writer(std::size_t id, std::size_t keys, std::size_t size, double duration, process_result_t& r)
+{
+  std::vector<double> v(size);
+  std::string what;
+  const auto start = std::chrono::steady_clock::now();
+  const auto stop = start + std::chrono::duration<double>(duration);
+  std::uint64_t seq = 0;
+  for(auto now = start; now < stop; seq++)
+  {
+    fill(v, id, seq);
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool ok = cnr::param::set(key((seq + id) % keys), v, what);
+    now = std::chrono::steady_clock::now();
+    r.histogram[bucket(std::chrono::duration_cast<std::chrono::nanoseconds>(now - t0).count())]++;
+    r.ops++;
+    r.failed += ok ? 0 : 1;
+  }
+  r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct summary_t
+{
+  std::uint64_t ops = 0;
+  std::uint64_t failed = 0;
+  std::uint64_t torn = 0;
+  double seconds = 0;
+  std::uint64_t histogram[buckets] = {0};
+
+  void add(const process_result_t& r)
+  {
+    ops += r.ops;
+    failed += r.failed;
+    torn += r.torn;
+    seconds = std::max(seconds, r.seconds);
+    for(std::size_t b = 0; b < buckets; b++)
+    {
+      histogram[b] += r.histogram[b];
+    }
+  }
+
+  double percentile(double p) const
+  {
+    std::uint64_t count = 0;
+    const std::uint64_t target = static_cast<std::uint64_t>(std::ceil(p * double(ops)));
+    for(std::size_t b = 0; b < buckets; b++)
+    {
+      count += histogram[b];
+      if(count >= target && count > 0)
+      {
+        return double(bucket_value(b)) * 1e-3;
+      }
+    }
+    return 0.0;
+  }
+};
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  std::size_t readers = 4;
+  std::size_t writers = 1;
+  std::size_t keys = 16;
+  std::size_t size = 64;
+  double duration = 5.0;
+  bool block = false;
+  double max_p99 = 0.0;
+  std::string out;
+
+  po::options_description options("Concurrent readers and writers on the same keys", 160);
+  options.add_options()
+    ("help,h", "produce help message")
+    ("readers,r", po::value<std::size_t>(&readers)->default_value(readers), "reader processes")
+    ("writers,w", po::value<std::size_t>(&writers)->default_value(writers), "writer processes")
+    ("keys,k", po::value<std::size_t>(&keys)->default_value(keys), "number of keys")
+    ("size,s", po::value<std::size_t>(&size)->default_value(size), "elements of the values (checksum included)")
+    ("duration,d", po::value<double>(&duration)->default_value(duration), "duration in seconds")
+    ("block,b", po::bool_switch(&block), "parameter blocks of 64 elements, read by the real-time API ('size' is ignored)")
+    ("max-p99", po::value<double>(&max_p99)->default_value(max_p99), "fail if the p99 read latency [us] is higher, 0 to disable")
+    ("out,o", po::value<std::string>(&out), "JSON file of the results");
+
+  try
+  {
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, options), vm);
+    po::notify(vm);
+    if(vm.count("help"))
+    {
+      std::cout << options << std::endl;
+      return 0;
+    }
+  }
+  catch(std::exception& e)
+  {
+    std::cerr << e.what() << std::endl << options << std::endl;
+    return 1;
+  }
+  if(keys == 0 || size < 2 || readers + writers == 0)
+  {
+    std::cerr << "At least a key of two elements, and a process are needed" << std::endl;
+    return 1;
+  }
+
+  const boost::filesystem::path root = boost::filesystem::temp_directory_path()
+    / ("cnr_param_stress." + std::to_string(getpid()));
+  boost::filesystem::create_directories(root);
+  setenv("CNR_PARAM_ROOT_DIRECTORY", root.string().c_str(), 1);
+
+  // The keys exist before the processes start, so a failed read is always an error
+  std::string what;
+  if(block)
+  {
+    size = block_size;
+    std::vector<std::unique_ptr<cnr::param::Block<block_value_t>>> blocks;
+    bool ok = open_blocks(keys, true, blocks);
+    block_value_t b;
+    for(std::size_t k = 0; ok && k < keys; k++)
+    {
+      fill(b, 0, k);
+      ok = blocks[k]->set(b, what);
+    }
+    if(!ok)
+    {
+      std::cerr << "Error in creating the blocks: " << what << std::endl;
+      boost::filesystem::remove_all(root);
+      return 1;
+    }
+  }
+  std::vector<double> v(size);
+  for(std::size_t k = 0; !block && k < keys; k++)
+  {
+    fill(v, 0, k);
+    if(!cnr::param::set(key(k), v, what))
+    {
+      std::cerr << "Error in creating the key '" << key(k) << "': " << what << std::endl;
+      boost::filesystem::remove_all(root);
+      return 1;
+    }
+  }
+
+  struct child_t
+  {
+    pid_t pid;
+    int fd;
+    bool writer;
+  };
+  std::vector<child_t> children;
+  for(std::size_t i = 0; i < readers + writers; i++)
+  {
+    const bool is_writer = i >= readers;
+    int fds[2];
+    if(pipe(fds) != 0)
+    {
+      std::cerr << "Error in creating the pipe: " << std::strerror(errno) << std::endl;
+      break;
+    }
+    pid_t pid = fork();
+    if(pid == 0)
+    {
+      close(fds[0]);
+      process_result_t* r = new process_result_t();
+      if(is_writer)
+      {
+        block ? block_writer(i - readers + 1, keys, duration, *r) : writer(i - readers + 1, keys, size, duration, *r);
+      }
+      else
+      {
+        block ? block_reader(keys, duration, *r) : reader(keys, duration, *r);
+      }
+      const bool ok = write(fds[1], r, sizeof(process_result_t)) == sizeof(process_result_t);
+      close(fds[1]);
+      _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    if(pid < 0)
+    {
+      close(fds[0]);
+      std::cerr << "Error in forking: " << std::strerror(errno) << std::endl;
+      break;
+    }
+    children.push_back({pid, fds[0], is_writer});
+  }
+
+  summary_t reads;
+  summary_t writes;
+  int ret = children.size() == readers + writers ? 0 : 1;
+  process_result_t* r = new process_result_t();
+  for(const auto& c : children)
+  {
+    std::size_t n = 0;
+    char* buf = reinterpret_cast<char*>(r);
+    for(ssize_t m = 1; n < sizeof(process_result_t) && m > 0; n += m > 0 ? m : 0)
+    {
+      m = read(c.fd, buf + n, sizeof(process_result_t) - n);
+    }
+    close(c.fd);
+    int status = 0;
+    waitpid(c.pid, &status, 0);
+    if(n != sizeof(process_result_t) || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+      std::cerr << "The process " << c.pid << " failed" << std::endl;
+      ret = 1;
+      continue;
+    }
+    (c.writer ? writes : reads).add(*r);
+  }
+  delete r;
+  boost::filesystem::remove_all(root);
+
+  const std::size_t cores = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  const double reads_per_s = reads.seconds > 0 ? double(reads.ops) / reads.seconds : 0.0;
+  const double reads_per_s_per_core = reads_per_s / double(std::max<std::size_t>(1, std::min(readers, cores)));
+  const double writes_per_s = writes.seconds > 0 ? double(writes.ops) / writes.seconds : 0.0;
+
+  std::cout << std::fixed << std::setprecision(1)
+            << (block ? "blocks, " : "") << "readers: " << readers << ", writers: " << writers << ", keys: " << keys
+            << ", size: " << size
+            << ", cores: " << cores << std::endl
+            << "reads: " << reads.ops << " (" << reads_per_s << "/s, " << reads_per_s_per_core << "/s per core)"
+            << ", latency [us] p50: " << reads.percentile(0.5) << " p99: " << reads.percentile(0.99)
+            << " p999: " << reads.percentile(0.999) << std::endl
+            << "writes: " << writes.ops << " (" << writes_per_s << "/s), latency [us] p50: "
+            << writes.percentile(0.5) << " p99: " << writes.percentile(0.99) << std::endl
+            << "torn reads: " << reads.torn << ", failed reads: " << reads.failed
+            << ", failed writes: " << writes.failed << std::endl;
+
+  if(!out.empty())
+  {
+    std::ofstream json(out);
+    json << "{\n  \"block\": " << (block ? "true" : "false") << ",\n  \"readers\": " << readers
+         << ",\n  \"writers\": " << writers << ",\n  \"keys\": " << keys
+         << ",\n  \"size\": " << size << ",\n  \"cores\": " << cores << ",\n  \"reads\": " << reads.ops
+         << ",\n  \"reads_per_second\": " << reads_per_s << ",\n  \"reads_per_second_per_core\": "
+         << reads_per_s_per_core << ",\n  \"read_latency_us\": {\"p50\": " << reads.percentile(0.5)
+         << ", \"p99\": " << reads.percentile(0.99) << ", \"p999\": " << reads.percentile(0.999)
+         << "},\n  \"writes\": " << writes.ops << ",\n  \"writes_per_second\": " << writes_per_s
+         << ",\n  \"write_latency_us\": {\"p50\": " << writes.percentile(0.5) << ", \"p99\": "
+         << writes.percentile(0.99) << ", \"p999\": " << writes.percentile(0.999) << "},\n  \"torn_reads\": "
+         << reads.torn << ",\n  \"failed_reads\": " << reads.failed << ",\n  \"failed_writes\": " << writes.failed
+         << "\n}\n";
+  }
+
+  if(max_p99 > 0.0 && reads.percentile(0.99) > max_p99)
+  {
+    std::cerr << "The p99 read latency exceeds " << max_p99 << " us" << std::endl;
+    ret = 1;
+  }
+  return (ret != 0 || reads.torn > 0 || reads.failed > 0 || writes.failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,181 @@
+#ifndef CNR_PARAM_BENCHMARKS_YAML_GENERATOR
+#define CNR_PARAM_BENCHMARKS_YAML_GENERATOR
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace cnr
+{
+namespace param
+{
+namespace benchmarks
+{
+
+/**
+ * @brief Shape of a synthetic configuration.
+ *
+ * The keys are the leaves of a tree of namespaces with 'depth' levels (the last level being the keys) and 'fanout'
+ * children for each namespace. The keys are spread over the namespaces of the last level, so the tree has exactly
+ * 'keys' leaves. The first file stores the whole tree, each one of the next 'files - 1' files overrides a fraction
+ * 'duplication' of the keys with different values, as a launch file that superimposes the robot specific params on
+ * the defaults.
+ */
+struct yaml_tree_t
+{
+  std::size_t keys = 1000;
+  std::size_t depth = 4;
+  std::size_t fanout = 8;
+  std::vector<std::string> types = {"double", "int", "bool", "string", "vector", "matrix"};
+  double duplication = 0.1;
+  std::size_t files = 2;
+  std::uint32_t seed = 42;
+};
+
+namespace detail
+{
+
+inline std::string leaf_value(const std::string& type, std::size_t key, std::size_t file)
+{
+  const double v = double(key) + 0.5 * double(file);
+  std::stringstream ss;
+  if(type == "int")
+  {
+    ss << (key + file);
+  }
+  else if(type == "bool")
+  {
+    ss << (((key + file) % 2) ? "true" : "false");
+  }
+  else if(type == "string")
+  {
+    ss << "\"value_" << key << "_" << file << "\"";
+  }
+  else if(type == "vector")
+  {
+    ss << "[" << v << ", " << v + 1 << ", " << v + 2 << ", " << v + 3 << ", " << v + 4 << ", " << v + 5 << "]";
+  }
+  else if(type == "matrix")
+  {
+    ss << "[[" << v << ", 0, 0], [0, " << v << ", 0], [0, 0, " << v << "]]";
+  }
+  else
+  {
+    ss << v;
+  }
+  return ss.str();
+}
+
+}  // namespace detail
+
+/**
+ * @brief Write the YAML documents of the tree, one per file, in 'output_prefix_<i>.yaml'.
+ *
+ * The generation is deterministic given the 'seed', so the scaling curves can be reproduced on different machines.
+ *
+ * @param tree
+ * @param output_prefix
+ * @param files the paths of the written files
+ * @param what
+ * @return true
+ * @return false
+ */
+inline bool generate_yaml(const yaml_tree_t& tree, const std::string& output_prefix, std::vector<std::string>& files,
+                          std::string& what)
+{
+  if(tree.keys == 0 || tree.depth == 0 || tree.fanout == 0 || tree.types.empty() || tree.files == 0
+    || tree.duplication < 0.0 || tree.duplication > 1.0)
+  {
+    what = "Invalid shape of the tree: keys, depth, fanout, types and files must not be empty, "
+           "and the duplication ratio must be in [0, 1]";
+    return false;
+  }
+
+  // Number of namespaces of the last level, never more than the keys
+  std::size_t namespaces = 1;
+  for(std::size_t l = 1; l < tree.depth && namespaces * tree.fanout <= tree.keys; l++)
+  {
+    namespaces *= tree.fanout;
+  }
+  const std::size_t keys_per_ns = (tree.keys + namespaces - 1) / namespaces;
+
+  std::mt19937 rng(tree.seed);
+  std::vector<std::size_t> types(tree.keys);
+  std::uniform_int_distribution<std::size_t> type_dist(0, tree.types.size() - 1);
+  for(auto& t : types)
+  {
+    t = type_dist(rng);
+  }
+
+  std::vector<std::size_t> all(tree.keys);
+  for(std::size_t i = 0; i < tree.keys; i++)
+  {
+    all[i] = i;
+  }
+
+  files.clear();
+  for(std::size_t f = 0; f < tree.files; f++)
+  {
+    std::vector<std::size_t> keys = all;
+    if(f > 0)
+    {
+      std::shuffle(keys.begin(), keys.end(), rng);
+      keys.resize(static_cast<std::size_t>(tree.duplication * double(tree.keys)));
+      std::sort(keys.begin(), keys.end());
+    }
+
+    const std::string fn = output_prefix + "_" + std::to_string(f) + ".yaml";
+    std::ofstream out(fn);
+    if(!out)
+    {
+      what = "Error in opening the file '" + fn + "'";
+      return false;
+    }
+
+    // The keys are sorted, so the keys of the same namespace are contiguous and each namespace is opened once
+    std::vector<std::size_t> previous;
+    for(const auto& k : keys)
+    {
+      std::vector<std::size_t> path;
+      for(std::size_t ns = k / keys_per_ns, n = namespaces; n > 1; n /= tree.fanout)
+      {
+        path.push_back((ns / (n / tree.fanout)) % tree.fanout);
+      }
+
+      std::size_t level = 0;
+      while(level < path.size() && level < previous.size() && path[level] == previous[level])
+      {
+        level++;
+      }
+      for(; level < path.size(); level++)
+      {
+        out << std::string(2 * level, ' ') << "ns" << level << "_" << path[level] << ":\n";
+      }
+      previous = path;
+
+      out << std::string(2 * path.size(), ' ') << "key_" << k << ": "
+          << detail::leaf_value(tree.types[types[k]], k, f) << "\n";
+    }
+    if(keys.empty())
+    {
+      out << "{}\n";
+    }
+    if(!out)
+    {
+      what = "Error in writing the file '" + fn + "'";
+      return false;
+    }
+    files.push_back(fn);
+  }
+  return true;
+}
+
+}  // namespace benchmarks
+}  // namespace param
+}  // namespace cnr
+
+#endif  /* CNR_PARAM_BENCHMARKS_YAML_GENERATOR */
@@ -0,0 +1,256 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_BIND
+#define CNR_PARAM_INCLUDE_CNR_PARAM_BIND
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+
+#include <cnr_param/cnr_param.h>
+
+/**
+ * Declarative binding of the fields of a struct to the keys of a map node. The binding generates the decoder of the
+ * struct, so that the struct can be read by 'get', 'extract' and 'decode' as the builtin types, alone or as the
+ * element of a sequence:
+ *
+ *   struct Joint { std::string name; double max_velocity; };
+ *   CNR_PARAM_BIND(Joint, CNR_PARAM_FIELD(name), CNR_PARAM_FIELD_KEY(max_velocity, "max_vel"))
+ *
+ *   std::vector<Joint> joints;
+ *   cnr::param::get("/robot/joints", joints, what);
+ *
+ * The table of the fields is built at compile time, with a perfect hash of the keys: the decoder reads the map node
+ * in a single pass, and it looks up each key of the node without any allocation. The keys of the node that are not
+ * bound are ignored, while all the bound fields are required. The macro must be used in the global namespace.
+ */
+#define CNR_PARAM_BIND(TYPE, ...)                                                                   \
+  namespace cnr                                                                                     \
+  {                                                                                                 \
+  namespace param                                                                                   \
+  {                                                                                                 \
+  template<>                                                                                        \
+  struct binding<TYPE>                                                                              \
+  {                                                                                                 \
+    using bound_t = TYPE;                                                                           \
+    static constexpr auto fields() { return std::make_tuple(__VA_ARGS__); }                         \
+  };                                                                                                \
+  template<>                                                                                        \
+  struct decoder<TYPE> : bound_decoder<TYPE>                                                        \
+  {                                                                                                 \
+  };                                                                                                \
+  }                                                                                                 \
+  }
+
+/**
+ * The field bound to the key with the same name of the member, or to the given key
+ */
+#define CNR_PARAM_FIELD(MEMBER) ::cnr::param::field(#MEMBER, &bound_t::MEMBER)
+#define CNR_PARAM_FIELD_KEY(MEMBER, KEY) ::cnr::param::field(KEY, &bound_t::MEMBER)
+
+namespace cnr
+{
+namespace param
+{
+
+/**
+ * @brief The fields of T, specialized by CNR_PARAM_BIND
+ */
+template<typename T>
+struct binding;
+
+template<typename C, typename M>
+struct field_t
+{
+  const char* key;
+  std::size_t length;
+  M C::* member;
+};
+
+constexpr std::size_t _key_length(const char* key)
+{
+  std::size_t n = 0;
+  while(key[n] != '\0')
+  {
+    n++;
+  }
+  return n;
+}
+
+template<typename C, typename M>
+constexpr field_t<C, M> field(const char* key, M C::* member)
+{
+  return field_t<C, M>{key, _key_length(key), member};
+}
+
+// FNV-1a, with a seed to search the perfect hash
+constexpr std::uint64_t _key_hash(const char* key, std::size_t length, std::uint64_t seed)
+{
+  std::uint64_t h = 14695981039346656037ull ^ (seed * 0x9e3779b97f4a7c15ull);
+  for(std::size_t i = 0; i < length; i++)
+  {
+    h = (h ^ static_cast<unsigned char>(key[i])) * 1099511628211ull;
+  }
+  return h ^ (h >> 29);
+}
+
+constexpr bool _key_equal(const char* a, std::size_t na, const char* b, std::size_t nb)
+{
+  if(na != nb)
+  {
+    return false;
+  }
+  for(std::size_t i = 0; i < na; i++)
+  {
+    if(a[i] != b[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief The perfect hash of N keys: the slot of each key is free of collisions, for the seed found at compile time.
+ * The slots are eight times the keys, so that a seed is found in a few tens of trials also for 64 keys.
+ */
+template<std::size_t N>
+struct field_table_t
+{
+  static constexpr std::size_t capacity = [] {
+    std::size_t c = 1;
+    while(c < 8 * N)
+    {
+      c <<= 1;
+    }
+    return c;
+  }();
+
+  std::uint64_t seed = 0;
+  bool unique = false;  // the keys are not duplicated
+  bool seeded = false;  // a seed without collisions has been found
+  std::array<const char*, N> key{};
+  std::array<std::size_t, N> length{};
+  std::array<std::uint8_t, capacity> slot{};  // index of the field + 1, 0 if the slot is free
+
+  /**
+   * @brief The index of the field of the key, or N if the key is not bound
+   */
+  std::size_t find(const char* k, std::size_t n) const
+  {
+    const std::uint8_t s = slot[_key_hash(k, n, seed) & (capacity - 1)];
+    return (s != 0 && _key_equal(key[s - 1], length[s - 1], k, n)) ? s - 1 : N;
+  }
+};
+
+template<std::size_t N>
+constexpr field_table_t<N> _make_field_table(const std::array<const char*, N>& keys)
+{
+  field_table_t<N> table;
+  for(std::size_t i = 0; i < N; i++)
+  {
+    table.key[i] = keys[i];
+    table.length[i] = _key_length(keys[i]);
+    for(std::size_t j = 0; j < i; j++)
+    {
+      if(_key_equal(table.key[i], table.length[i], table.key[j], table.length[j]))
+      {
+        return table;  // duplicated keys, not valid
+      }
+    }
+  }
+  table.unique = true;
+
+  for(std::uint64_t seed = 0; seed < (1u << 12); seed++)
+  {
+    std::array<std::uint8_t, field_table_t<N>::capacity> slot{};
+    bool collision = false;
+    for(std::size_t i = 0; i < N && !collision; i++)
+    {
+      std::uint8_t& s = slot[_key_hash(table.key[i], table.length[i], seed) & (field_table_t<N>::capacity - 1)];
+      collision = s != 0;
+      s = static_cast<std::uint8_t>(i + 1);
+    }
+    if(!collision)
+    {
+      table.seed = seed;
+      table.slot = slot;
+      table.seeded = true;
+      break;
+    }
+  }
+  return table;
+}
+
+/**
+ * @brief The decoder generated by CNR_PARAM_BIND
+ */
+template<typename T>
+struct bound_decoder
+{
+  static constexpr auto fields = binding<T>::fields();
+  static constexpr std::size_t size = std::tuple_size<std::decay_t<decltype(fields)>>::value;
+
+  static_assert(size > 0 && size <= 64, "CNR_PARAM_BIND supports from 1 up to 64 fields");
+
+  template<std::size_t... I>
+  static constexpr std::array<const char*, size> keys(std::index_sequence<I...>)
+  {
+    return {{std::get<I>(fields).key...}};
+  }
+
+  static constexpr field_table_t<size> table = _make_field_table<size>(keys(std::make_index_sequence<size>()));
+
+  static_assert(table.unique, "CNR_PARAM_BIND: the keys of the fields must be unique");
+  static_assert(!table.unique || table.seeded, "CNR_PARAM_BIND: no perfect hash has been found for the keys");
+
+  template<std::size_t... I>
+  static bool decode_field(const node_t& node, std::size_t i, T& ret, param_error& err, std::index_sequence<I...>)
+  {
+    bool ok = false;
+    static_cast<void>(((i == I && (ok = _decode_node(node, ret.*(std::get<I>(fields).member), err), true)) || ...));
+    return ok;
+  }
+
+  static bool decode(const node_t& node, T& ret, param_error& err)
+  {
+    if(!node.IsMap())
+    {
+      return err.fail(error_code_t::not_a_map, typeid(T));
+    }
+
+    std::uint64_t found = 0;
+    for(auto it = node.begin(); it != node.end(); ++it)
+    {
+      const std::string& k = it->first.Scalar();
+      const std::size_t i = table.find(k.data(), k.size());
+      if(i == size)
+      {
+        continue;
+      }
+      if(!decode_field(it->second, i, ret, err, std::make_index_sequence<size>()))
+      {
+        err.detail = "In the field '" + k + "'" + (err.detail.empty() ? "" : ": " + err.detail);
+        return false;
+      }
+      found |= std::uint64_t(1) << i;
+    }
+
+    for(std::size_t i = 0; i < size; i++)
+    {
+      if(!(found & (std::uint64_t(1) << i)))
+      {
+        err.detail = std::string("The field '") + table.key[i] + "' is missing";
+        return err.fail(error_code_t::missing_key, typeid(T));
+      }
+    }
+    return true;
+  }
+};
+
+}  // namespace param
+}  // namespace cnr
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_BIND */
@@ -0,0 +1,166 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_BLOCK
+#define CNR_PARAM_INCLUDE_CNR_PARAM_BLOCK
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include <cnr_param/cnr_param.h>
+#include <cnr_param/utils/block.h>
+
+/**
+ * Parameter blocks for the real-time readers. A block stores a trivially-copyable value in three buffers of a file
+ * mapping, '<root>/<key>.block': 'set' fills a back buffer and flips the front buffer, and 'get' copies the front
+ * buffer in constant time, without locks and without retries, so a reader never waits on a writer. The handle is
+ * opened once, out of the real-time loop, and it keeps the mapping:
+ *
+ *   cnr::param::Block<Gains> gains;
+ *   gains.open("/ctrl/gains", what);
+ *   ...
+ *   Gains g;
+ *   gains.get(g);                      // in the loop
+ *
+ *   auto front = gains.borrow();       // or, without the copy
+ *   double kp = front->kp;
+ *
+ * A borrowed buffer is not rewritten until it is released: the writers use the other two, and they wait only if the
+ * readers hold both of them. The blocks are not part of the YAML tree: they are not read by 'get' of the namespaces.
+ *
+ * A crashed process never hangs the others: the lock of a dead writer is taken over by the next one, and the buffer
+ * pinned by a dead reader is left aside. If the dead readers hold two buffers, 'set' fails after its timeout, until the
+ * block file is removed and opened again.
+ */
+
+namespace cnr
+{
+namespace param
+{
+
+template<typename T>
+class Block
+{
+  static_assert(std::is_trivially_copyable<T>::value, "A parameter block stores only the trivially-copyable types");
+
+public:
+  /**
+   * @brief The front buffer pinned by a reader, released by the destructor
+   */
+  class Borrowed
+  {
+  public:
+    Borrowed() = default;
+    Borrowed(const Borrowed&) = delete;
+    Borrowed& operator=(const Borrowed&) = delete;
+    Borrowed(Borrowed&& other) noexcept : buffer_(other.buffer_), index_(other.index_) { other.buffer_ = nullptr; }
+    ~Borrowed()
+    {
+      if(buffer_)
+      {
+        buffer_->unpin(index_);
+      }
+    }
+
+    explicit operator bool() const { return buffer_ != nullptr; }
+    const T& operator*() const { return *reinterpret_cast<const T*>(buffer_->data(index_)); }
+    const T* operator->() const { return reinterpret_cast<const T*>(buffer_->data(index_)); }
+
+  private:
+    friend class Block<T>;
+    Borrowed(const cnr::param::utils::BlockBuffer* buffer, std::uint32_t index) : buffer_(buffer), index_(index) {}
+
+    const cnr::param::utils::BlockBuffer* buffer_ = nullptr;
+    std::uint32_t index_ = 0;
+  };
+
+  Block() = default;
+  Block(const Block&) = delete;
+  Block& operator=(const Block&) = delete;
+  ~Block() = default;
+
+  /**
+   * @brief Map the block of the param. The block is created if it does not exist and 'create' is true (i.e., by the
+   * writers), otherwise the open fails until the first writer creates it.
+   *
+   * @param[in] key: full path
+   * @param[out] what: a message with the error
+   * @param[in] create: create the block if it does not exist
+   * @return false if the block does not exist, or if it has been created for another type
+   */
+  bool open(const std::string& key, std::string& what, bool create = false)
+  {
+    boost::filesystem::path ap;
+    if(!cnr::param::absolutepath(key, false, ap, what))
+    {
+      return false;
+    }
+    ap.replace_extension(".block");
+    return buffer_.open(ap.string(), sizeof(T), _pod_fingerprint<T>(), create, what);
+  }
+
+  explicit operator bool() const { return static_cast<bool>(buffer_); }
+
+  /**
+   * @brief Publish the value. The writers are serialized.
+   *
+   * @param[in] value
+   * @param[out] what: a message with the error
+   * @param[in] timeout: the longest wait for a free back buffer
+   * @return false if the block is not open, or if the lock or the back buffers are held after the timeout
+   */
+  bool set(const T& value, std::string& what,
+            std::chrono::nanoseconds timeout = std::chrono::milliseconds(100))
+  {
+    if(!buffer_)
+    {
+      what = "The block is not open";
+      return false;
+    }
+    return buffer_.write(&value, timeout, what);
+  }
+
+  /**
+   * @brief Copy the front buffer. It never waits.
+   *
+   * @return false if the block is not open, or if no value has been published yet
+   */
+  bool get(T& ret) const
+  {
+    if(!buffer_ || buffer_.updates() == 0)
+    {
+      return false;
+    }
+    const std::uint32_t index = buffer_.pin();
+    std::memcpy(&ret, buffer_.data(index), sizeof(T));
+    buffer_.unpin(index);
+    return true;
+  }
+
+  /**
+   * @brief Pin the front buffer, to read it in place. It never waits.
+   *
+   * @return an empty handle if the block is not open, or if no value has been published yet
+   */
+  Borrowed borrow() const
+  {
+    if(!buffer_ || buffer_.updates() == 0)
+    {
+      return Borrowed();
+    }
+    return Borrowed(&buffer_, buffer_.pin());
+  }
+
+  /**
+   * @brief The values published, to detect a new value
+   */
+  std::uint64_t updates() const { return buffer_ ? buffer_.updates() : 0; }
+
+private:
+  cnr::param::utils::BlockBuffer buffer_;
+};
+
+}  // namespace param
+}  // namespace cnr
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_BLOCK */
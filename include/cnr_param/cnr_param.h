@@ -1,6 +1,10 @@
 #ifndef SRC_CNR_PARAM_INCLUDE_CNR_PARAM_CNR_PARAM
 #define SRC_CNR_PARAM_INCLUDE_CNR_PARAM_CNR_PARAM
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
@@ -8,12 +12,15 @@
 #include <vector>
 #include <string>
 #include <boost/array.hpp>
+#include <boost/container/flat_map.hpp>
 #include <boost/type_index.hpp>
 #include <bitset>
 
 #include <Eigen/Core>
 
 #include "cnr_param/visibility_control.h"
+#include "cnr_param/error.h"
+#include "cnr_param/matrix.h"
 
 
 
@@ -38,6 +45,14 @@ namespace cnr
 namespace param
 {
 
+/**
+ * @brief The sorted map stored in a contiguous array, decoded from a map node as std::map and std::unordered_map.
+ * The lookup is a binary search on contiguous memory, faster than the node-based maps for the tables read on the hot
+ * paths (e.g., the limits of the joints by name).
+ */
+template<typename K, typename T>
+using flat_map = boost::container::flat_map<K, T>;
+
 //======================================================================================================================
 //=== USER FUNCTIONS ===================================================================================================/**
 /**
@@ -49,6 +64,15 @@ namespace param
  */
 bool has(const std::string& key, std::string& what);
 
+/**
+ * @brief As 'has', but no message is formatted if the param is missing: the error is recorded in 'err'
+ *
+ * @param[in] key to find (full path)
+ * @param[out] err
+ * @return true if the param is stored
+ */
+bool has(const std::string& key, param_error& err);
+
 /**
  * @brief get the param, and return true if found and ok. Store the error(s) in 'what'. If a default value is present,
  * it superimposes the defaul values, and it return true, but it stores a warning in 'what'. Typical error is the
@@ -76,6 +100,43 @@ bool get(const std::string& key, T& ret, std::string& what, const T& default_val
 template<typename T>
 bool get(const std::string& key, T& ret, std::string& what);
 
+/**
+ * @brief As 'get', but the error is recorded in 'err', and no message is formatted unless 'err.message()' is called.
+ * It is the cheap way to probe optional params, or params of unknown type.
+ *
+ * @param[in] key to find (full path)
+ * @param[out] ret the value of the element
+ * @param[out] err the record of the error
+ * @return true if ok
+ */
+template<typename T>
+bool get(const std::string& key, T& ret, param_error& err);
+
+/**
+ * @brief As 'get' with the default value. If the default value is superimposed, it returns true, and 'err' records
+ * that the param is missing.
+ */
+template<typename T>
+bool get(const std::string& key, T& ret, param_error& err, const T& default_val);
+
+/**
+ * @brief The param, or the error. It never throws: the failures, as a missing key or a mismatch of the types, cost
+ * about as much as a successful read.
+ *
+ *   auto gain = cnr::param::try_get<double>("/ctrl/gain");
+ *   if(!gain) { ... gain.error().message() ... }
+ *
+ * @param[in] key to find (full path)
+ */
+template<typename T>
+expected<T> try_get(const std::string& key);
+
+/**
+ * @brief As 'try_get', but the default value is returned if the param is missing
+ */
+template<typename T>
+expected<T> try_get(const std::string& key, const T& default_val);
+
 /**
 * @brief set the param, and return true if found and ok. Store the error(s) in 'what'. Typical error is the
 * mismatch of types between the actual parameter and the required type
@@ -88,6 +149,128 @@ bool get(const std::string& key, T& ret, std::string& what);
 template<typename T>
 bool set(const std::string& key, const T& ret, std::string& what);
 
+/**
+ * @brief The version of the layout of T, stored in its POD blobs. The fingerprint of a blob already covers the size,
+ * the alignment and the name of the type: bump the version when the fields of T are changed (e.g., reordered) without
+ * changing them, so that the readers built with the old layout are rejected:
+ *
+ *   template<> struct cnr::param::pod_version<Gains> : std::integral_constant<std::uint32_t, 2> {};
+ */
+template<typename T>
+struct pod_version : std::integral_constant<std::uint32_t, 0> {};
+
+/**
+ * @brief Store a trivially-copyable object as a blob of bytes, with the fingerprint of its layout, so that it is read
+ * by 'get_pod' with a single memcpy, without any YAML conversion. The other readers of the param (e.g., 'get' of a
+ * namespace that contains it) get the bytes encoded in base64.
+ *
+ * @param[in] key: full path
+ * @param[in] val: object to be stored
+ * @param[out] what: a message with the error
+ * @return true if ok
+ */
+template<typename T>
+bool set_pod(const std::string& key, const T& val, std::string& what);
+
+/**
+ * @brief Read an object stored by 'set_pod'. The blob is rejected before copying it if it has not been stored by
+ * 'set_pod' ('error_code_t::not_a_blob'), or if its fingerprint is not the one of T ('error_code_t::layout_mismatch'),
+ * e.g., a writer built with another definition of the struct. If the read fails, 'ret' is not modified.
+ *
+ * @param[in] key to find (full path)
+ * @param[out] ret the object
+ * @param[out] err the error
+ * @return true if ok
+ */
+template<typename T>
+bool get_pod(const std::string& key, T& ret, param_error& err);
+
+template<typename T>
+bool get_pod(const std::string& key, T& ret, std::string& what);
+
+/**
+ * @brief A group of 'set' published together: the readers see either all the values or none of them.
+ * The values are staged in memory by 'set', and 'commit' writes them and publishes them with a single generation
+ * bump, so that the cost of the commit depends only on the staged keys. If a namespace and one of its descendants
+ * are set in the same transaction, the readers of the namespace get the value of the descendant.
+ */
+class Transaction
+{
+public:
+  Transaction() = default;
+  Transaction(const Transaction&) = delete;
+  Transaction& operator=(const Transaction&) = delete;
+  ~Transaction() = default;
+
+  /**
+   * @brief Stage the value of the param. The value is copied, and it is written only by 'commit'
+   *
+   * @param[in] key: full path
+   * @param[in] value: element to be stored
+   * @param[out] what: a message with the error
+   * @return false if the key is ill-formed
+   */
+  template<typename T>
+  bool set(const std::string& key, const T& value, std::string& what);
+
+  /**
+   * @brief Write and publish all the staged values. If a write fails, none of the values is published, and the staged
+   * values are kept.
+   *
+   * @param[out] what: a message with the error
+   * @return true if all the values have been published
+   */
+  bool commit(std::string& what);
+
+  /**
+   * @brief Drop the staged values
+   */
+  void clear() { staged_.clear(); }
+
+  std::size_t size() const { return staged_.size(); }
+
+private:
+  std::vector<std::function<bool(std::uint64_t, std::vector<std::string>&, std::string&)>> staged_;
+};
+
+/**
+ * @brief Consistent reads of several params: all the 'get' of a snapshot read the params published at the generation
+ * pinned when the snapshot was taken, while the writers go on. The values read are cached, so that they are not
+ * copied and parsed again. Since each param keeps only its last two versions, a param updated twice after the
+ * snapshot cannot be read anymore: 'get' fails, and 'refresh' pins the last generation.
+ */
+class Snapshot
+{
+public:
+  Snapshot();
+  Snapshot(const Snapshot&) = delete;
+  Snapshot& operator=(const Snapshot&) = delete;
+  ~Snapshot() = default;
+
+  /**
+   * @brief get the param at the generation of the snapshot
+   *
+   * @param[in] key to find (full path)
+   * @param[out] ret the value of the element
+   * @param[out] what: a message with the error
+   * @return true if ok
+   */
+  template<typename T>
+  bool get(const std::string& key, T& ret, std::string& what);
+
+  /**
+   * @brief Pin the last published generation, and drop the cached values
+   */
+  void refresh();
+
+  std::uint64_t generation() const { return generation_; }
+
+private:
+  struct Cached;
+  std::uint64_t generation_;
+  std::unordered_map<std::string, std::shared_ptr<Cached>> cache_;
+};
+
 /**
  * @brief 
  * 
@@ -189,6 +372,42 @@ bool at(const cnr::param::node_t& node, const std::string& key, T& element, std:
 template<typename T>
 T extract(const node_t& node, const std::string& key ="", const std::string& error_heading_msgs ="");
 
+/**
+ * @brief Decode the node in the templated object. It is the core of 'extract', without exceptions: the error is
+ * recorded in 'err'.
+ *
+ * @tparam T
+ * @param node
+ * @param ret
+ * @param err
+ * @return true if ok
+ */
+template<typename T>
+bool decode(const node_t& node, T& ret, param_error& err);
+
+/**
+ * @brief The decoder of T used by 'decode', 'extract' and 'get'. It is selected at compile time by the family of T
+ * (arithmetic, std::string, std::vector, std::array, Eigen matrix, cnr::param::Matrix, std::map, std::unordered_map,
+ * flat_map), so that a type that cannot be decoded does not compile. The other classes are decoded by the specializations of 'get_scalar', 'get_sequence' and 'get_map', or
+ * by a specialization of 'decoder', that registers the decoder of the class:
+ *
+ *   template<> struct cnr::param::decoder<MyType>
+ *   {
+ *     static bool decode(const cnr::param::node_t& node, MyType& ret, cnr::param::param_error& err);
+ *   };
+ *
+ * @tparam T
+ * @tparam Enable to specialize the decoder of a family of types with std::enable_if
+ */
+template<typename T, typename Enable = void>
+struct decoder;
+
+/**
+ * @brief As 'extract', but it returns the error instead of throwing it
+ */
+template<typename T>
+expected<T> try_extract(const node_t& node, const std::string& key = "");
+
 /**
  * @brief 
  * 
@@ -0,0 +1,190 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_ERROR
+#define CNR_PARAM_INCLUDE_CNR_PARAM_ERROR
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <variant>
+
+namespace cnr
+{
+namespace param
+{
+
+enum class error_code_t : std::uint8_t
+{
+  none = 0,
+  missing_key,       // the param is not stored, or the key is not a child of the node
+  undefined_node,    // the node is null or undefined
+  not_a_scalar,
+  not_a_sequence,
+  not_a_map,
+  bad_conversion,    // the scalar cannot be converted in the requested type
+  size_mismatch,     // the size of the sequence does not fit the requested type
+  unsupported_type,  // there is not a decoder for the requested type
+  decoder,           // a user decoder failed, its message is in 'detail'
+  storage,           // the param cannot be read from the storage, the message is in 'detail'
+  not_a_blob,        // the param has not been stored by 'set_pod'
+  layout_mismatch    // the POD blob has been stored with another layout than the requested type
+};
+
+const char* to_string(error_code_t code);
+
+/**
+ * @brief The record of a failed read. The decoders fill only the code, the type and the position of the failed
+ * element, without formatting any string: the message is rendered by 'message()' only if the caller asks for it.
+ */
+struct param_error
+{
+  static constexpr std::size_t max_depth = 4;
+
+  error_code_t          code = error_code_t::none;
+  std::uint8_t          depth = 0;              // number of the valid indexes in 'index'
+  bool                  truncated = false;      // the outermost indexes, beyond 'max_depth', have been dropped
+  std::uint32_t         index[max_depth] = {};  // position of the failed element, from the outermost sequence
+  const std::type_info* type = nullptr;         // type of the failed element
+  const std::type_info* requested = nullptr;    // type requested by the caller
+  std::size_t           expected = 0;           // sizes, for 'size_mismatch'
+  std::size_t           actual = 0;
+  std::string           key;                    // param, or key of the node
+  std::string           detail;                 // message of a user decoder, or of the storage
+
+  explicit operator bool() const { return code != error_code_t::none; }
+
+  /**
+   * @brief Record the failure, and return false, so that a decoder can 'return err.fail(...)'
+   */
+  bool fail(error_code_t c, const std::type_info& t)
+  {
+    code = c;
+    type = &t;
+    return false;
+  }
+
+  /**
+   * @brief Record the index of the element that failed. It is called while the error goes up through the nested
+   * sequences, so the index is prepended. Beyond 'max_depth', the outermost indexes are dropped, and the path is
+   * marked as truncated.
+   */
+  void at(std::size_t i)
+  {
+    if(depth == max_depth)
+    {
+      truncated = true;
+    }
+    else
+    {
+      for(std::size_t d = depth; d > 0; d--)
+      {
+        index[d] = index[d - 1];
+      }
+      index[0] = static_cast<std::uint32_t>(std::min<std::size_t>(i, std::numeric_limits<std::uint32_t>::max()));
+      depth++;
+    }
+  }
+
+  void clear()
+  {
+    code = error_code_t::none;
+    depth = 0;
+    truncated = false;
+    type = nullptr;
+    requested = nullptr;
+    expected = actual = 0;
+    key.clear();
+    detail.clear();
+  }
+
+  /**
+   * @brief The human-readable message of the error
+   */
+  std::string message() const;
+};
+
+/**
+ * @brief The error of an 'expected', to construct it from the error
+ */
+template<typename E>
+struct unexpected
+{
+  explicit unexpected(E e) : error(std::move(e)) {}
+  E error;
+};
+
+/**
+ * @brief The value, or the error of a call that failed, as the std::expected of C++23: the functions that return it
+ * never throw to report a failure.
+ */
+template<typename T, typename E = param_error>
+class expected
+{
+public:
+  expected(const T& value) : v_(std::in_place_index<0>, value) {}
+  expected(T&& value) : v_(std::in_place_index<0>, std::move(value)) {}
+  expected(unexpected<E>&& e) : v_(std::in_place_index<1>, std::move(e.error)) {}
+  expected(const unexpected<E>& e) : v_(std::in_place_index<1>, e.error) {}
+
+  bool has_value() const { return v_.index() == 0; }
+  explicit operator bool() const { return has_value(); }
+
+  /**
+   * @brief The value. It throws only if there is not a value, with the message of the error.
+   */
+  T& value() &
+  {
+    check();
+    return std::get<0>(v_);
+  }
+  const T& value() const &
+  {
+    check();
+    return std::get<0>(v_);
+  }
+  T&& value() &&
+  {
+    check();
+    return std::get<0>(std::move(v_));
+  }
+
+  T& operator*() { return std::get<0>(v_); }
+  const T& operator*() const { return std::get<0>(v_); }
+  T* operator->() { return &std::get<0>(v_); }
+  const T* operator->() const { return &std::get<0>(v_); }
+
+  const E& error() const { return std::get<1>(v_); }
+  E& error() { return std::get<1>(v_); }
+
+  template<typename U>
+  T value_or(U&& default_value) const &
+  {
+    return has_value() ? std::get<0>(v_) : static_cast<T>(std::forward<U>(default_value));
+  }
+
+private:
+  void check() const
+  {
+    if(!has_value())
+    {
+      if constexpr(std::is_same<E, param_error>::value)
+      {
+        throw std::runtime_error(std::get<1>(v_).message());
+      }
+      else
+      {
+        throw std::runtime_error("The expected has not a value");
+      }
+    }
+  }
+
+  std::variant<T, E> v_;
+};
+
+}  // namespace param
+}  // namespace cnr
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_ERROR */
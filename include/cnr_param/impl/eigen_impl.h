@@ -11,7 +11,9 @@
 #endif
 
 #include <random>
+#include <type_traits>
 #include <cnr_param/utils/eigen.h>
+#include <cnr_param/utils/logger.h>
 
 
 namespace cnr 
@@ -21,6 +23,16 @@ namespace param
 namespace utils
 {
 
+/**
+ * @brief true if the object owns its coefficients (a Matrix, or the matrix view of an Array), false for the views
+ * (Map, Block, ...), whose 'resize' only asserts that the size does not change
+ */
+template<typename Derived>
+struct is_resizable : std::is_base_of<Eigen::PlainObjectBase<Derived>, Derived> {};
+
+template<typename Expression>
+struct is_resizable<Eigen::MatrixWrapper<Expression>> : is_resizable<typename std::remove_const<Expression>::type> {};
+
 /**
  * RESIZE - SAFE FUNCTION CALLED ONLY IF THE MATRIX IS DYNAMICALLY CREATED AT RUNTIME
  */
@@ -31,18 +43,23 @@ template<typename Derived,
 inline bool resize(Eigen::MatrixBase<Derived> const & m, int rows, int cols)
 {
   Eigen::MatrixBase<Derived>& mat = const_cast< Eigen::MatrixBase<Derived>& >(m);
-  if((Eigen::MatrixBase<Derived>::RowsAtCompileTime ==Eigen::Dynamic) 
+  if constexpr(!is_resizable<Derived>::value)
+  {
+    // a view keeps its size: it fits only if it already has the requested one
+    return (mat.rows() == rows) && (mat.cols() == cols);
+  }
+  else if((Eigen::MatrixBase<Derived>::RowsAtCompileTime ==Eigen::Dynamic) 
   && (Eigen::MatrixBase<Derived>::ColsAtCompileTime ==Eigen::Dynamic))
   {
     mat.derived().resize(rows,cols);
   }
   else if(Eigen::MatrixBase<Derived>::RowsAtCompileTime ==Eigen::Dynamic) 
   {
-    mat.derived().resize(rows,Eigen::NoChange);
+    mat.derived().resize(rows, mat.cols());  // NoChange is not forwarded by the wrappers of the arrays
   }
   else if(Eigen::MatrixBase<Derived>::ColsAtCompileTime ==Eigen::Dynamic) 
   {
-    mat.derived().resize(Eigen::NoChange, cols);
+    mat.derived().resize(mat.rows(), cols);
   }
   return (mat.derived().rows() == rows) && (mat.derived().cols() == cols);
 }
@@ -446,8 +463,8 @@ inline bool copy_to_block(double& lhs, const double& rhs,
   bool ret = startRow==0 && startCol==0 && blockRows==1 && blockCols==1;
   if(!ret)
   {
-    std::cerr << "Error: " << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments " 
-              <<  startRow <<","<< startCol <<","<< blockRows <<","<< blockCols << std::endl;
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments "
+              << startRow << "," << startCol << "," << blockRows << "," << blockCols);
   }
   return ret;
 }
@@ -462,8 +479,8 @@ inline bool copy_to_block(Eigen::MatrixBase<LHS>& lhs, const Eigen::MatrixBase<R
     lhs.block(startRow, startCol, blockRows, blockCols) = rhs;
     return true;
   }
-  std::cerr << "Error: " << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments" 
-              <<  startRow <<","<< startCol <<","<< blockRows <<","<< blockCols << std::endl;
+  CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments "
+              << startRow << "," << startCol << "," << blockRows << "," << blockCols);
   return false;
 }
 
@@ -476,8 +493,8 @@ inline bool copy_to_block(Eigen::MatrixBase<Derived>& lhs, const double& rhs,
     lhs.block(startRow, startCol, blockRows, blockCols).setConstant(rhs);
     return true;
   }
-  std::cerr << "Error: " << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments" 
-              <<  startRow <<","<< startCol <<","<< blockRows <<","<< blockCols << std::endl;
+  CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments "
+              << startRow << "," << startCol << "," << blockRows << "," << blockCols);
   return false;
 }
 
@@ -532,8 +549,8 @@ inline bool copy_from_block(double& lhs, const double& rhs,
   bool ret = startRow==0 && startCol==0 && blockRows==1 && blockCols==1;
   if(!ret)
   {
-    std::cerr << "Error: " << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments" 
-              <<  startRow <<","<< startCol <<","<< blockRows <<","<< blockCols << std::endl;
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments "
+              << startRow << "," << startCol << "," << blockRows << "," << blockCols);
   }
   return ret;
 }
@@ -548,8 +565,8 @@ inline bool copy_from_block(Eigen::MatrixBase<LHS>& lhs, const Eigen::MatrixBase
     lhs = rhs.block(startRow, startCol, blockRows, blockCols);
     return true;
   }
-  std::cerr << "Error: " << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments" 
-              <<  startRow <<","<< startCol <<","<< blockRows <<","<< blockCols << std::endl;
+  CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments "
+              << startRow << "," << startCol << "," << blockRows << "," << blockCols);
   return false;
 }
 
@@ -562,8 +579,8 @@ inline bool copy_from_block(Eigen::MatrixBase<Derived>& lhs, const double& rhs,
     lhs.setConstant(rhs);
     return true;
   }
-  std::cerr << "Error: " << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments" 
-              <<  startRow <<","<< startCol <<","<< blockRows <<","<< blockCols << std::endl;
+  CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": arguments "
+              << startRow << "," << startCol << "," << blockRows << "," << blockCols);
   return false;
 }
 
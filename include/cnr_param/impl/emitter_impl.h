@@ -0,0 +1,288 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_IMPL_EMITTER_IMPL
+#define CNR_PARAM_INCLUDE_CNR_PARAM_IMPL_EMITTER_IMPL
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <cnr_param/utils/emitter.h>
+
+#if !defined(UNUSED)
+#define UNUSED(expr) do { (void)(expr); } while (0)
+#endif
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+
+template<typename T, typename A>
+struct is_emittable<std::vector<T, A>, typename std::enable_if<is_emittable_scalar<T>::value>::type>
+  : std::true_type {};
+
+template<typename T, typename A, typename B>
+struct is_emittable<std::vector<std::vector<T, A>, B>, typename std::enable_if<is_emittable_scalar<T>::value>::type>
+  : std::true_type {};
+
+template<typename Derived>
+struct is_emittable<Derived, typename std::enable_if<std::is_base_of<Eigen::DenseBase<Derived>, Derived>::value
+                                                      && is_emittable_scalar<typename Derived::Scalar>::value>::type>
+  : std::true_type {};
+
+namespace detail
+{
+
+/**
+ * @brief maximum number of chars of a number written by 'emit_scalar'
+ */
+template<typename T>
+constexpr std::size_t max_chars()
+{
+  return std::is_same<T, bool>::value    ? 5
+       : std::is_floating_point<T>::value ? std::numeric_limits<T>::max_digits10 + 10
+       : std::numeric_limits<T>::digits10 + 3;
+}
+
+constexpr std::size_t separator_chars = 2;  // ", "
+
+inline bool emit_chars(char*& p, char* last, const char* str, std::size_t n)
+{
+  if(static_cast<std::size_t>(last - p) < n)
+  {
+    return false;
+  }
+  std::memcpy(p, str, n);
+  p += n;
+  return true;
+}
+
+template<typename T>
+inline bool emit_scalar(char*& p, char* last, const T& value)
+{
+  if constexpr(std::is_same<T, bool>::value)
+  {
+    return value ? emit_chars(p, last, "true", 4) : emit_chars(p, last, "false", 5);
+  }
+  else
+  {
+    if constexpr(std::is_floating_point<T>::value)
+    {
+      if(std::isnan(value))
+      {
+        return emit_chars(p, last, ".nan", 4);
+      }
+      if(std::isinf(value))
+      {
+        return value > 0 ? emit_chars(p, last, ".inf", 4) : emit_chars(p, last, "-.inf", 5);
+      }
+    }
+    auto res = std::to_chars(p, last, value);
+    if(res.ec != std::errc())
+    {
+      return false;
+    }
+    p = res.ptr;
+    return true;
+  }
+}
+
+/**
+ * @brief the key is always double-quoted, so that any character is allowed in the name of the parameter
+ */
+inline std::size_t key_capacity(const std::string& key)
+{
+  return 4 * key.size() + 4;  // worst case: every char escaped as \xNN, plus quotes and ': '
+}
+
+inline bool emit_key(char*& p, char* last, const std::string& key)
+{
+  static const char hex[] = "0123456789abcdef";
+  if(!emit_chars(p, last, "\"", 1))
+  {
+    return false;
+  }
+  for(const char c : key)
+  {
+    const unsigned char u = static_cast<unsigned char>(c);
+    if(c == '"' || c == '\\')
+    {
+      const char esc[2] = {'\\', c};
+      if(!emit_chars(p, last, esc, 2))
+        return false;
+    }
+    else if(u < 0x20 || u == 0x7f)
+    {
+      const char esc[4] = {'\\', 'x', hex[u >> 4], hex[u & 0xf]};
+      if(!emit_chars(p, last, esc, 4))
+        return false;
+    }
+    else if(!emit_chars(p, last, &c, 1))
+    {
+      return false;
+    }
+  }
+  return emit_chars(p, last, "\": ", 3);
+}
+
+template<typename Iterator>
+inline bool emit_flow_sequence(char*& p, char* last, Iterator begin, Iterator end)
+{
+  if(!emit_chars(p, last, "[", 1))
+  {
+    return false;
+  }
+  for(auto it = begin; it != end; ++it)
+  {
+    if(it != begin && !emit_chars(p, last, ", ", separator_chars))
+    {
+      return false;
+    }
+    if(!emit_scalar(p, last, *it))
+    {
+      return false;
+    }
+  }
+  return emit_chars(p, last, "]", 1);
+}
+
+template<typename T>
+inline std::size_t value_capacity(const T& value)
+{
+  if constexpr(is_emittable_scalar<T>::value)
+  {
+    UNUSED(value);
+    return max_chars<T>();
+  }
+  else if constexpr(std::is_base_of<Eigen::DenseBase<T>, T>::value)
+  {
+    const std::size_t n = static_cast<std::size_t>(value.size());
+    const std::size_t rows = static_cast<std::size_t>(value.rows());
+    return n * (max_chars<typename T::Scalar>() + separator_chars) + rows * (2 + separator_chars) + 2;
+  }
+  else  // std::vector<S> or std::vector<std::vector<S>>
+  {
+    using S = typename T::value_type;
+    if constexpr(is_emittable_scalar<S>::value)
+    {
+      return value.size() * (max_chars<S>() + separator_chars) + 2;
+    }
+    else
+    {
+      std::size_t ret = 2;
+      for(const auto& row : value)
+      {
+        ret += value_capacity(row) + separator_chars;
+      }
+      return ret;
+    }
+  }
+}
+
+template<typename T>
+inline bool emit_value(char*& p, char* last, const T& value)
+{
+  if constexpr(is_emittable_scalar<T>::value)
+  {
+    return emit_scalar(p, last, value);
+  }
+  else if constexpr(std::is_base_of<Eigen::DenseBase<T>, T>::value)
+  {
+    // the vectors are stored as a flat sequence, while the matrices row by row, as expected by the 'get'
+    if constexpr(T::IsVectorAtCompileTime)
+    {
+      const auto& v = value.derived();
+      if(!emit_chars(p, last, "[", 1))
+      {
+        return false;
+      }
+      for(Eigen::Index i = 0; i < v.size(); i++)
+      {
+        if((i > 0 && !emit_chars(p, last, ", ", separator_chars)) || !emit_scalar(p, last, v(i)))
+        {
+          return false;
+        }
+      }
+      return emit_chars(p, last, "]", 1);
+    }
+    else
+    {
+      if(!emit_chars(p, last, "[", 1))
+      {
+        return false;
+      }
+      for(Eigen::Index i = 0; i < value.rows(); i++)
+      {
+        if((i > 0 && !emit_chars(p, last, ", ", separator_chars)) || !emit_chars(p, last, "[", 1))
+        {
+          return false;
+        }
+        for(Eigen::Index j = 0; j < value.cols(); j++)
+        {
+          if((j > 0 && !emit_chars(p, last, ", ", separator_chars)) || !emit_scalar(p, last, value(i, j)))
+          {
+            return false;
+          }
+        }
+        if(!emit_chars(p, last, "]", 1))
+        {
+          return false;
+        }
+      }
+      return emit_chars(p, last, "]", 1);
+    }
+  }
+  else
+  {
+    using S = typename T::value_type;
+    if constexpr(is_emittable_scalar<S>::value)
+    {
+      return emit_flow_sequence(p, last, value.begin(), value.end());
+    }
+    else
+    {
+      if(!emit_chars(p, last, "[", 1))
+      {
+        return false;
+      }
+      for(auto it = value.begin(); it != value.end(); ++it)
+      {
+        if((it != value.begin() && !emit_chars(p, last, ", ", separator_chars))
+          || !emit_flow_sequence(p, last, it->begin(), it->end()))
+        {
+          return false;
+        }
+      }
+      return emit_chars(p, last, "]", 1);
+    }
+  }
+}
+
+}  // namespace detail
+
+template<typename T>
+inline std::size_t emit_capacity(const std::string& key, const T& value)
+{
+  static_assert(is_emittable<T>::value, "The type is not supported by the fast emitter");
+  return detail::key_capacity(key) + detail::value_capacity(value) + 1;  // trailing '\n'
+}
+
+template<typename T>
+inline std::size_t emit(char* first, char* last, const std::string& key, const T& value)
+{
+  static_assert(is_emittable<T>::value, "The type is not supported by the fast emitter");
+  char* p = first;
+  if(!detail::emit_key(p, last, key) || !detail::emit_value(p, last, value) || !detail::emit_chars(p, last, "\n", 1))
+  {
+    return 0;
+  }
+  return static_cast<std::size_t>(p - first);
+}
+
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_IMPL_EMITTER_IMPL */
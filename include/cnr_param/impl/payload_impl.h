@@ -0,0 +1,309 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_IMPL_PAYLOAD_IMPL
+#define CNR_PARAM_INCLUDE_CNR_PARAM_IMPL_PAYLOAD_IMPL
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <cnr_param/utils/eigen.h>
+#include <cnr_param/utils/payload.h>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+
+template<typename S>
+constexpr scalar_t scalar_type()
+{
+  return std::is_same<S, double>::value       ? scalar_t::float64
+       : std::is_same<S, float>::value        ? scalar_t::float32
+       : std::is_same<S, std::int64_t>::value ? scalar_t::int64
+       : std::is_same<S, std::int32_t>::value ? scalar_t::int32
+       : std::is_same<S, std::int16_t>::value ? scalar_t::int16
+       : std::is_same<S, std::uint8_t>::value ? scalar_t::uint8
+       : scalar_t::none;
+}
+
+template<typename Derived>
+struct is_binary_matrix<Derived, typename std::enable_if<std::is_base_of<Eigen::DenseBase<Derived>, Derived>::value
+                                            && scalar_type<typename Derived::Scalar>() != scalar_t::none>::type>
+  : std::true_type {};
+
+inline std::size_t scalar_size(scalar_t s)
+{
+  switch(s)
+  {
+    case scalar_t::float64: return sizeof(double);
+    case scalar_t::float32: return sizeof(float);
+    case scalar_t::int64:   return sizeof(std::int64_t);
+    case scalar_t::int32:   return sizeof(std::int32_t);
+    case scalar_t::int16:   return sizeof(std::int16_t);
+    case scalar_t::uint8:   return sizeof(std::uint8_t);
+    default: return 0;
+  }
+}
+
+template<typename Derived>
+inline std::size_t matrix_payload_size(const Eigen::DenseBase<Derived>& m)
+{
+  return sizeof(matrix_header_t) + static_cast<std::size_t>(m.size()) * sizeof(typename Derived::Scalar);
+}
+
+template<typename Derived>
+inline std::size_t write_matrix(char* data, const Eigen::DenseBase<Derived>& m)
+{
+  using Scalar = typename Derived::Scalar;
+  static_assert(scalar_type<Scalar>() != scalar_t::none, "The scalar type cannot be stored in a binary payload");
+
+  // No copy if 'Derived' is a plain matrix, the expressions are evaluated once
+  const typename Derived::PlainObject& plain = m.derived();
+
+  matrix_header_t header;
+  header.scalar   = static_cast<std::uint32_t>(scalar_type<Scalar>());
+  header.flags    = (Derived::PlainObject::IsRowMajor ? matrix_flags::row_major : 0u)
+                  | (Derived::IsVectorAtCompileTime ? matrix_flags::vector : 0u);
+  header.rows     = static_cast<std::int64_t>(plain.rows());
+  header.cols     = static_cast<std::int64_t>(plain.cols());
+  header.reserved = 0;
+
+  const std::size_t n = static_cast<std::size_t>(plain.size()) * sizeof(Scalar);
+  std::memcpy(data, &header, sizeof(matrix_header_t));
+  std::memcpy(data + sizeof(matrix_header_t), plain.data(), n);
+  return sizeof(matrix_header_t) + n;
+}
+
+namespace detail
+{
+
+/**
+ * @brief True if the integral value 'v' can be represented in the integral type D
+ */
+template<typename D, typename S>
+inline bool fits(S v)
+{
+  if constexpr(std::is_signed<S>::value)
+  {
+    constexpr std::intmax_t min = static_cast<std::intmax_t>(std::numeric_limits<D>::min());
+    return v < 0 ? std::is_signed<D>::value && static_cast<std::intmax_t>(v) >= min
+                 : static_cast<std::uintmax_t>(v) <= static_cast<std::uintmax_t>(std::numeric_limits<D>::max());
+  }
+  else
+  {
+    return static_cast<std::uintmax_t>(v) <= static_cast<std::uintmax_t>(std::numeric_limits<D>::max());
+  }
+}
+
+/**
+ * @brief Copy the coefficients of type S, stored in the given order, in 'ret', already resized
+ *
+ * @return false if a coefficient cannot be represented in the scalar of 'ret', as 'convert_coeffs'
+ */
+template<typename S, typename Derived>
+inline bool copy_coeffs(const char* src, bool row_major, Eigen::MatrixBase<Derived>& ret)
+{
+  using Scalar = typename Derived::Scalar;
+  const S* coeffs = reinterpret_cast<const S*>(src);
+  if constexpr(std::is_floating_point<S>::value && std::is_integral<Scalar>::value)
+  {
+    return false;
+  }
+  else
+  {
+    if constexpr(std::is_same<S, Scalar>::value && std::is_base_of<Eigen::PlainObjectBase<Derived>, Derived>::value)
+    {
+      if(Derived::IsVectorAtCompileTime || row_major == bool(Derived::IsRowMajor))
+      {
+        std::memcpy(ret.derived().data(), coeffs, static_cast<std::size_t>(ret.size()) * sizeof(S));
+        return true;
+      }
+    }
+
+    if constexpr(std::is_integral<Scalar>::value && !std::is_same<S, Scalar>::value)
+    {
+      for(Eigen::Index i = 0; i < ret.size(); i++)
+      {
+        S v;
+        std::memcpy(&v, src + i * sizeof(S), sizeof(S));
+        if(!fits<Scalar>(v))
+        {
+          return false;
+        }
+      }
+    }
+
+    if(row_major)
+    {
+      ret = Eigen::Map<const Eigen::Matrix<S, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+        coeffs, ret.rows(), ret.cols()).template cast<Scalar>();
+    }
+    else
+    {
+      ret = Eigen::Map<const Eigen::Matrix<S, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor>>(
+        coeffs, ret.rows(), ret.cols()).template cast<Scalar>();
+    }
+    return true;
+  }
+}
+
+/**
+ * @brief Copy the coefficients of type S, stored in the given order, in 'dst' row by row
+ *
+ * @return false if a coefficient cannot be represented in D
+ */
+template<typename S, typename D>
+inline bool convert_coeffs(const char* src, std::size_t rows, std::size_t cols, bool row_major, D* dst)
+{
+  if constexpr(std::is_floating_point<S>::value && std::is_integral<D>::value)
+  {
+    return false;
+  }
+  else
+  {
+    if constexpr(std::is_same<S, D>::value)
+    {
+      if(row_major || rows == 1 || cols == 1)
+      {
+        std::memcpy(dst, src, rows * cols * sizeof(S));
+        return true;
+      }
+    }
+
+    for(std::size_t r = 0; r < rows; r++)
+    {
+      for(std::size_t c = 0; c < cols; c++)
+      {
+        S v;
+        std::memcpy(&v, src + (row_major ? r * cols + c : c * rows + r) * sizeof(S), sizeof(S));
+        if constexpr(std::is_integral<D>::value && !std::is_same<S, D>::value)
+        {
+          if(!fits<D>(v))
+          {
+            return false;
+          }
+        }
+        dst[r * cols + c] = static_cast<D>(v);
+      }
+    }
+    return true;
+  }
+}
+
+}  // namespace detail
+
+template<typename Derived>
+inline bool read_matrix(const char* data, std::size_t size, Eigen::MatrixBase<Derived> const& ret, std::string& what)
+{
+  Eigen::MatrixBase<Derived>& _ret = const_cast< Eigen::MatrixBase<Derived>& >(ret);
+
+  if(size < sizeof(matrix_header_t))
+  {
+    what = "The binary payload is truncated";
+    return false;
+  }
+  matrix_header_t header;
+  std::memcpy(&header, data, sizeof(matrix_header_t));
+
+  const scalar_t scalar = static_cast<scalar_t>(header.scalar);
+  const std::size_t n = static_cast<std::size_t>(header.rows * header.cols);
+  if(header.rows < 0 || header.cols < 0 || scalar_size(scalar) == 0
+    || size < sizeof(matrix_header_t) + n * scalar_size(scalar))
+  {
+    what = "The binary payload is corrupted";
+    return false;
+  }
+
+  const int rows = static_cast<int>(header.rows);
+  const int cols = static_cast<int>(header.cols);
+  constexpr int expected_rows = Eigen::MatrixBase<Derived>::RowsAtCompileTime;
+  constexpr int expected_cols = Eigen::MatrixBase<Derived>::ColsAtCompileTime;
+  bool ok = false;
+  if(Derived::IsVectorAtCompileTime)
+  {
+    const int dim = static_cast<int>(n);
+    ok = (rows == 1 || cols == 1)
+      && cnr::param::utils::resize(_ret, (expected_rows == 1 ? 1 : dim), (expected_rows == 1 ? dim : 1));
+  }
+  else
+  {
+    ok = cnr::param::utils::resize(_ret, rows, cols);
+  }
+  if(!ok)
+  {
+    what = "It was expected a Matrix (" + std::to_string(expected_rows) + "x" + std::to_string(expected_cols)
+      + ") while the param store a (" + std::to_string(rows) + "x" + std::to_string(cols) + ") matrix";
+    return false;
+  }
+
+  const char* coeffs = data + sizeof(matrix_header_t);
+  const bool row_major = header.flags & matrix_flags::row_major;
+  bool converted = false;
+  switch(scalar)
+  {
+    case scalar_t::float64: converted = detail::copy_coeffs<double>(coeffs, row_major, _ret); break;
+    case scalar_t::float32: converted = detail::copy_coeffs<float>(coeffs, row_major, _ret); break;
+    case scalar_t::int64:   converted = detail::copy_coeffs<std::int64_t>(coeffs, row_major, _ret); break;
+    case scalar_t::int32:   converted = detail::copy_coeffs<std::int32_t>(coeffs, row_major, _ret); break;
+    case scalar_t::int16:   converted = detail::copy_coeffs<std::int16_t>(coeffs, row_major, _ret); break;
+    case scalar_t::uint8:   converted = detail::copy_coeffs<std::uint8_t>(coeffs, row_major, _ret); break;
+    default: return false;
+  }
+  if(!converted)
+  {
+    what = "The coefficients stored in the param cannot be converted in the scalar of the requested matrix "
+      "without loss";
+  }
+  return converted;
+}
+
+template<typename S>
+inline bool read_numbers(const char* data, std::size_t size, std::vector<S>& values, number_shape_t& shape)
+{
+  if(size < sizeof(matrix_header_t))
+  {
+    return false;
+  }
+  matrix_header_t header;
+  std::memcpy(&header, data, sizeof(matrix_header_t));
+
+  const scalar_t scalar = static_cast<scalar_t>(header.scalar);
+  if(header.rows < 0 || header.cols < 0 || scalar_size(scalar) == 0)
+  {
+    return false;
+  }
+  const std::size_t rows = static_cast<std::size_t>(header.rows);
+  const std::size_t cols = static_cast<std::size_t>(header.cols);
+  if(size < sizeof(matrix_header_t) + rows * cols * scalar_size(scalar))
+  {
+    return false;
+  }
+
+  values.resize(rows * cols);
+  const char* coeffs = data + sizeof(matrix_header_t);
+  const bool row_major = header.flags & matrix_flags::row_major;
+  S* out = values.data();
+  bool ok = false;
+  switch(scalar)
+  {
+    case scalar_t::float64: ok = detail::convert_coeffs<double>(coeffs, rows, cols, row_major, out); break;
+    case scalar_t::float32: ok = detail::convert_coeffs<float>(coeffs, rows, cols, row_major, out); break;
+    case scalar_t::int64:   ok = detail::convert_coeffs<std::int64_t>(coeffs, rows, cols, row_major, out); break;
+    case scalar_t::int32:   ok = detail::convert_coeffs<std::int32_t>(coeffs, rows, cols, row_major, out); break;
+    case scalar_t::int16:   ok = detail::convert_coeffs<std::int16_t>(coeffs, rows, cols, row_major, out); break;
+    case scalar_t::uint8:   ok = detail::convert_coeffs<std::uint8_t>(coeffs, rows, cols, row_major, out); break;
+    default: return false;
+  }
+
+  shape.nested = !(header.flags & matrix_flags::vector);
+  shape.rows = shape.nested ? rows : 1;
+  shape.cols = shape.nested ? cols : rows * cols;
+  return ok;
+}
+
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_IMPL_PAYLOAD_IMPL */
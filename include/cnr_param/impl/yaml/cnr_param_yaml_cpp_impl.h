@@ -36,7 +36,13 @@
 #ifndef CNR_PARAM_INCLUDE_CNR_PARAM_IMPL_YAML_CNR_PARAM_YAML_CPP_IMPL
 #define CNR_PARAM_INCLUDE_CNR_PARAM_IMPL_YAML_CNR_PARAM_YAML_CPP_IMPL
 
+#include <array>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <iostream>
 #include <iomanip>
@@ -53,8 +59,14 @@
 #include <cnr_param/cnr_param.h>
 #include <cnr_param/utils/string.h>
 #include <cnr_param/utils/eigen.h>
+#include <cnr_param/utils/emitter.h>
 #include <cnr_param/utils/filesystem.h>
+#include <cnr_param/utils/logger.h>
 #include <cnr_param/utils/interprocess.h>
+#include <cnr_param/utils/numbers.h>
+#include <cnr_param/utils/patch.h>
+#include <cnr_param/utils/payload.h>
+#include <cnr_param/utils/stats.h>
 
 #include <yaml-cpp/exceptions.h>
 
@@ -73,6 +85,30 @@ namespace param
 //                                                                                 //
 //                                                                                 //
 // =============================================================================== //
+inline bool rootpath(boost::filesystem::path& root, std::string& what)
+{
+  const char* env_p = std::getenv("CNR_PARAM_ROOT_DIRECTORY");
+  if(!env_p)
+  {
+    what = (what.size() ? (what + "\n") : std::string("") ) +
+      "The env variable CNR_PARAM_ROOT_DIRECTORY is not set!" ;
+      return false;
+  }
+  root = boost::filesystem::path(std::string(env_p));
+  return true;
+}
+
+/**
+ * @brief The last generation published under the root directory, i.e., the version of the params that 'get' reads
+ */
+inline std::uint64_t current_generation()
+{
+  boost::filesystem::path root;
+  std::string what;
+  return rootpath(root, what) ? cnr::param::utils::currentGeneration(root.string())
+                              : std::numeric_limits<std::uint64_t>::max() - 1;
+}
+
 inline bool absolutepath(const std::string& key, const bool check_if_exist, boost::filesystem::path& ap, std::string& what)
 {
   if((key.size()==0)||(key.front()!='/'))
@@ -80,19 +116,17 @@ inline bool absolutepath(const std::string& key, const bool check_if_exist, boos
     what = "The key '"+key+"' is ill-formed. cnr_param support only aboslute path, i.e., the key must start with '/'";
     return false;
   }
-  const char* env_p = std::getenv("CNR_PARAM_ROOT_DIRECTORY");
-  if(!env_p)
+  boost::filesystem::path root;
+  if(!rootpath(root, what))
   {
-    what = (what.size() ? (what + "\n") : std::string("") ) +
-      "The env variable CNR_PARAM_ROOT_DIRECTORY is not set!" ;
-      return false;
+    return false;
   }
   std::string _key = key;
   while(_key.back()=='/')
   {
     _key.pop_back();
   }
-  boost::filesystem::path p = boost::filesystem::path(std::string(env_p)) / (_key + ".yaml");
+  boost::filesystem::path p = root / (_key + ".yaml");
 
   if(check_if_exist)
   {
@@ -111,37 +145,167 @@ inline bool absolutepath(const std::string& key, const bool check_if_exist, boos
 inline bool has(const std::string& key, std::string& what)
 {
   boost::filesystem::path ap; 
-  if(!absolutepath(key, true, ap, what))
+  return CNR_PARAM_PROBE(has, key, absolutepath(key, true, ap, what));
+}
+
+inline bool _has(const std::string& key, param_error& err)
+{
+  boost::filesystem::path ap;
+  std::string what;
+  if(!absolutepath(key, false, ap, what))
   {
+    err.code = error_code_t::storage;
+    err.key = key;
+    err.detail = what;
+    return false;
+  }
+  boost::system::error_code ec;
+  if(!boost::filesystem::is_regular_file(ap, ec))
+  {
+    err.code = error_code_t::missing_key;
+    err.key = key;
     return false;
   }
   return true;
 }
 
-inline bool recover(const std::string& key, YAML::Node& node, std::string& what)
+inline bool has(const std::string& key, param_error& err)
 {
-  boost::filesystem::path ap; 
+  return CNR_PARAM_PROBE(has, key, _has(key, err));
+}
+
+inline bool recover(const std::string& key, cnr::param::utils::EntryReader& entry, std::string& what)
+{
+  boost::filesystem::path ap;
   if(!absolutepath(key, true, ap, what))
   {
     return false;
   }
+  return entry.open(ap.string(), what);
+}
 
-  //Create a file mapping
-  boost::interprocess::file_mapping file(ap.string().c_str(), boost::interprocess::read_only);
+inline bool recover(const std::string& key, const cnr::param::utils::entry_copy_t& copy, const std::string& path,
+                      std::uint64_t generation, YAML::Node& node, std::string& what);
 
-  //Map the whole file with read-write permissions in this process
-  boost::interprocess::mapped_region region(file, boost::interprocess::read_only);
+/**
+ * @brief Graft the value of the descendants updated after the namespace was written. A descendant is grafted only
+ * if its version, at the generation, is not older than the namespace. It fails if a descendant has been overwritten
+ * after the generation.
+ */
+inline bool graft(const std::string& key, const std::vector<std::string>& relative_keys, std::uint64_t generation, 
+                    std::uint64_t version, YAML::Node& node, std::string& what)
+{
+  std::string _key = key;
+  while(_key.back()=='/')
+  {
+    _key.pop_back();
+  }
 
-  //Get the address of the mapped region
-  void * addr       = region.get_address();
-  std::size_t size  = region.get_size();
-  UNUSED(size);
-  
-  //Check that memory was initialized to 1
-  const char *mem = static_cast<char*>(addr);
-  std::string strmem(mem);
+  for(const auto& relative_key : relative_keys)
+  {
+    const std::string child = _key + "/" + relative_key;
+    cnr::param::utils::EntryReader entry;
+    cnr::param::utils::entry_copy_t copy;
+    std::string err;
+    if(!recover(child, entry, err))
+    {
+      continue;
+    }
+    if(!entry.copy(generation, copy))
+    {
+      if(entry.expired(generation))
+      {
+        what = "The param '" + child + "' has been overwritten after the generation " + std::to_string(generation);
+        return false;
+      }
+      continue;
+    }
+    if(copy.generation < version)
+    {
+      continue;
+    }
+    YAML::Node value;
+    if(!recover(child, copy, entry.path(), generation, value, what))
+    {
+      return false;
+    }
+
+    auto tokens = cnr::param::utils::tokenize("/" + relative_key, "/");
+    if(tokens.size()==0)
+    {
+      continue;
+    }
+    if(!node.IsMap())
+    {
+      node = YAML::Node(YAML::NodeType::Map);
+    }
+    YAML::Node cursor(node);
+    for(std::size_t i=0; i<tokens.size()-1; i++)
+    {
+      if(!cursor[tokens.at(i)].IsMap())
+      {
+        cursor[tokens.at(i)] = YAML::Node(YAML::NodeType::Map);
+      }
+      YAML::Node next = cursor[tokens.at(i)];
+      cursor.reset(next);
+    }
+    cursor[tokens.back()] = value;
+  }
+  return true;
+}
+
+/**
+ * @brief Copy the payload of the entry published at the generation
+ */
+inline bool recover(const std::string& key, const cnr::param::utils::EntryReader& entry, std::uint64_t generation, 
+                      cnr::param::utils::entry_copy_t& copy, std::string& what)
+{
+  if(!entry.copy(generation, copy))
+  {
+    what = entry.expired(generation) 
+         ? "The param '" + key + "' has been overwritten after the generation " + std::to_string(generation)
+         : "The param '" + key + "' has not been published yet";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Parse the copied payload, and graft the descendants patched after it
+ */
+inline bool _recover(const std::string& key, const cnr::param::utils::entry_copy_t& copy, const std::string& path,
+                      std::uint64_t generation, YAML::Node& node, std::string& what)
+{
+  std::vector<std::string> patches;
+  if(copy.flags & cnr::param::utils::entry_flags::patched)
+  {
+    std::string err;
+    cnr::param::utils::readPatches(path, patches, err);
+  }
+
+  if(copy.type == cnr::param::utils::payload_t::matrix)
+  {
+    if(!cnr::param::utils::matrix_to_yaml(copy.data.data(), copy.data.size(), node, what))
+    {
+      return false;
+    }
+    return graft(key, patches, generation, copy.generation, node, what);
+  }
+  if(copy.type == cnr::param::utils::payload_t::pod)
+  {
+    return cnr::param::utils::pod_to_yaml(copy.data.data(), copy.data.size(), node, what);
+  }
 
-  auto config = YAML::Load(strmem);
+  YAML::Node config;
+  try
+  {
+    config = YAML::Load(copy.data);
+  }
+  catch(std::exception& e)
+  {
+    what = "The param '" + key + "' is corrupted: " + e.what();
+    return false;
+  }
   if(config.size()==0)
   {
     what = "The namespace server is empty";
@@ -152,9 +316,47 @@ inline bool recover(const std::string& key, YAML::Node& node, std::string& what)
     what = "The key'"+key+"' is ill-formed, none '/' is present. Only Aboslute path are supported in cnr_param";
     return false;
   }
+  if(!config[tokens.back()])
+  {
+    return false;
+  }
   node = config[tokens.back()];
-  
-  return bool(config[tokens.back()]);
+  return graft(key, patches, generation, copy.generation, node, what);
+}
+
+inline bool recover(const std::string& key, const cnr::param::utils::entry_copy_t& copy, const std::string& path,
+                      std::uint64_t generation, YAML::Node& node, std::string& what)
+{
+  return CNR_PARAM_PROBE(recover, key, _recover(key, copy, path, generation, node, what));
+}
+
+inline bool recover(const std::string& key, std::uint64_t generation, YAML::Node& node, std::uint64_t& version, 
+                      std::string& what)
+{
+  cnr::param::utils::EntryReader entry;
+  cnr::param::utils::entry_copy_t copy;
+  if(!recover(key, entry, what) || !recover(key, entry, generation, copy, what))
+  {
+    return false;
+  }
+  version = copy.generation;
+  return recover(key, copy, entry.path(), generation, node, what);
+}
+
+inline bool recover(const std::string& key, YAML::Node& node, std::string& what)
+{
+  std::uint64_t version = 0;
+  std::uint64_t generation = current_generation();
+  while(!recover(key, generation, node, version, what))
+  {
+    if(generation == current_generation())
+    {
+      return false;
+    }
+    generation = current_generation();
+    CNR_PARAM_COUNT(retry);
+  }
+  return true;
 }
 // =============================================================================== //
 //                                                                                 //
@@ -166,6 +368,26 @@ inline bool recover(const std::string& key, YAML::Node& node, std::string& what)
 
 
 
+/**
+ * @brief The matrix view of an Eigen object, since the binary payloads are read through Eigen::MatrixBase
+ */
+template<typename T>
+inline decltype(auto) _as_matrix(T& ret)
+{
+  if constexpr(std::is_base_of<Eigen::ArrayBase<T>, T>::value)
+  {
+    return ret.matrix();
+  }
+  else
+  {
+    return ret;
+  }
+}
+
+// ffwd declaration: the bulk parser of the numbers is defined after the traits of the decoders
+template<typename T>
+bool _decode_numbers(const std::string& key, const cnr::param::utils::entry_copy_t& copy, T& ret);
+
 /**
  * @brief 
  * 
@@ -178,58 +400,569 @@ inline bool recover(const std::string& key, YAML::Node& node, std::string& what)
  * @return false 
  */
 template<typename T>
-inline bool get(const std::string& key, T& ret, std::string& what)
+inline bool _get(const std::string& key, T& ret, param_error& err)
+{
+  err.clear();
+  if (!cnr::param::has(key, err))
+  {
+    return false;
+  }
+
+  // the failures of the storage are rare: their messages are formatted, and stored in the record
+  auto storage = [&err, &key](std::string&& what)
+  {
+    err.code = error_code_t::storage;
+    err.key = key;
+    err.detail = std::move(what);
+    return false;
+  };
+
+  std::string what;
+  cnr::param::utils::EntryReader entry;
+  if (!cnr::param::recover(key, entry, what))
+  {
+    return storage(std::move(what));
+  }
+  std::uint64_t generation = current_generation();
+
+  if constexpr(cnr::param::utils::is_binary_matrix<T>::value)
+  {
+    // binary payload stored by 'set': the coefficients are copied without passing through the YAML parser
+    bool matrix = false;
+    bool ok = false;
+    std::string err_matrix;
+    std::uint64_t seq;
+    do
+    {
+      seq = entry.begin();
+      int s = entry.slot(generation);
+      matrix = s >= 0 && entry.type(s) == cnr::param::utils::payload_t::matrix;
+      ok = matrix && cnr::param::utils::read_matrix(entry.data(s), entry.size(s), _as_matrix(ret), err_matrix);
+    } while(entry.retry(seq));
+
+    if(matrix)
+    {
+      if(!ok)
+      {
+        err.requested = &typeid(T);
+        return storage(std::move(err_matrix));
+      }
+      return ok;
+    }
+  }
+
+  // If the version read has been overwritten meanwhile, the newer generation is read. The sequences of numbers are
+  // converted by the bulk parser, the other values are parsed as YAML
+  cnr::param::utils::entry_copy_t copy;
+  YAML::Node node;
+  bool bulk = false;
+  while(!cnr::param::recover(key, entry, generation, copy, what)
+    || (!(bulk = _decode_numbers(key, copy, ret)) && !cnr::param::recover(key, copy, entry.path(), generation, node, what)))
+  {
+    if(generation == current_generation())
+    {
+      return storage(std::move(what));
+    }
+    generation = current_generation();
+    CNR_PARAM_COUNT(retry);
+  }
+
+  if(bulk)
+  {
+    return true;
+  }
+  if(!cnr::param::decode(node, ret, err))
+  {
+    err.key = key;
+    return false;
+  }
+  return true;
+}
+
+template<typename T>
+inline bool _get(const std::string& key, T& ret, std::string& what)
+{
+  param_error err;
+  if(!_get(key, ret, err))
+  {
+    what = err.message();
+    return false;
+  }
+  return true;
+}
+
+template<typename T>
+inline bool get(const std::string& key, T& ret, std::string& what)
+{
+  return CNR_PARAM_PROBE(get, key, _get(key, ret, what));
+}
+
+template<typename T>
+inline bool get(const std::string& key, T& ret, param_error& err)
+{
+  return CNR_PARAM_PROBE(get, key, _get(key, ret, err));
+}
+
+template<typename T>
+inline expected<T> try_get(const std::string& key)
+{
+  T ret;
+  param_error err;
+  if(!cnr::param::get(key, ret, err))
+  {
+    return unexpected<param_error>(std::move(err));
+  }
+  return ret;
+}
+
+/**
+ * @brief Stage the value of the param with the generation of the writer. The entries written are appended to 'written'
+ */
+template<typename T>
+inline bool _set(const std::string& key, const T& ret, std::uint64_t generation, std::vector<std::string>& written,
+                  std::string& what)
+{
+  boost::filesystem::path ap; 
+  if(!absolutepath(key, false, ap, what))
+  {
+    return false;
+  }
+
+  auto keys = cnr::param::utils::tokenize(key, "/");
+
+  if constexpr(cnr::param::utils::is_binary_matrix<T>::value)
+  {
+    // Eigen objects are stored as shape and contiguous coefficients
+    std::size_t fsz = cnr::param::utils::matrix_payload_size(ret);
+    cnr::param::utils::EntryWriter entry(ap.string(), cnr::param::utils::payload_t::matrix, fsz, generation);
+    if(!entry)
+    {
+      what = "IMpossible to create the file mapping '" + ap.string() +"'";
+      return false;
+    }
+    entry.commit(cnr::param::utils::write_matrix(entry.data(), ret));
+  }
+  else if constexpr(cnr::param::utils::is_emittable<T>::value)
+  {
+    // Numbers and vectors are emitted directly in the mapped file, without YAML::Dump
+    std::size_t fsz = cnr::param::utils::emit_capacity(keys.back(), ret);
+    cnr::param::utils::EntryWriter entry(ap.string(), cnr::param::utils::payload_t::yaml, fsz, generation);
+    if(!entry)
+    {
+      what = "IMpossible to create the file mapping '" + ap.string() +"'";
+      return false;
+    }
+    std::size_t sz = cnr::param::utils::emit(entry.data(), entry.data() + fsz, keys.back(), ret);
+    if(!sz)
+    {
+      what = "Error in emitting the value of the param '" + key + "'";
+      return false;
+    }
+    entry.commit(sz);
+  }
+  else
+  {
+    YAML::Node _node;
+    _node[keys.back()] = ret;
+
+    std::string str = YAML::Dump(_node);
+    str +="\n";
+
+    cnr::param::utils::EntryWriter entry(ap.string(), cnr::param::utils::payload_t::yaml, str.size(), generation);
+    if(!entry)
+    {
+      what = "IMpossible to create the file mapping '" + ap.string() +"'";
+      return false;
+    }
+    std::memcpy(entry.data(), str.c_str(), str.size() );
+    entry.commit(str.size());
+  }
+  written.push_back(ap.string());
+
+  // The namespaces that contain the key are patched, so that their readers get the new value
+  boost::filesystem::path root = ap;
+  for(std::size_t i=0; i<keys.size(); i++)
+  {
+    root = root.parent_path();
+  }
+  return cnr::param::utils::patchAncestors(root, keys, generation, written, what);
+}
+
+/**
+ * @brief Drop the payloads staged by a writer that has not been published
+ */
+inline void _discard(const std::vector<std::string>& written, std::uint64_t generation)
+{
+  for(const auto& absolute_path : written)
+  {
+    cnr::param::utils::discardEntry(absolute_path, generation);
+  }
+}
+
+/**
+ * @brief Stage the value of the param, and publish it with a generation of its own
+ */
+template<typename T>
+inline bool _set(const std::string& key, const T& ret, std::string& what)
+{
+  boost::filesystem::path root;
+  if(!rootpath(root, what))
+  {
+    return false;
+  }
+  cnr::param::utils::GenerationLock lock(root.string());
+  if(!lock)
+  {
+    what = "Impossible to lock the root directory '" + root.string() + "'";
+    return false;
+  }
+
+  std::vector<std::string> written;
+  if(!_set(key, ret, lock.next(), written, what))
+  {
+    _discard(written, lock.next());
+    return false;
+  }
+  lock.publish();
+  return true;
+}
+
+template<typename T>
+bool set(const std::string& key, const T& ret, std::string& what)
+{
+  return CNR_PARAM_PROBE(set, key, _set(key, ret, what));
+}
+
+// =============================================================================================
+// POD BLOBS
+// =============================================================================================
+/**
+ * @brief The fingerprint of the layout of T: FNV-1a of its size, its alignment, its name (as spelled by the compiler
+ * in __PRETTY_FUNCTION__) and its pod_version. It is computed at compile time.
+ */
+template<typename T>
+constexpr std::uint64_t _pod_fingerprint()
+{
+#if defined(_MSC_VER)
+  const char* name = __FUNCSIG__;
+#else
+  const char* name = __PRETTY_FUNCTION__;
+#endif
+  std::uint64_t h = 14695981039346656037ull;
+  auto mix = [&h](std::uint64_t v)
+  {
+    for(int i = 0; i < 8; i++)
+    {
+      h = (h ^ ((v >> (8 * i)) & 0xff)) * 1099511628211ull;
+    }
+  };
+  mix(sizeof(T));
+  mix(alignof(T));
+  mix(pod_version<T>::value);
+  for(std::size_t i = 0; name[i] != '\0'; i++)
+  {
+    h = (h ^ static_cast<unsigned char>(name[i])) * 1099511628211ull;
+  }
+  return h;
+}
+
+template<typename T>
+inline bool _set_pod(const std::string& key, const T& val, std::uint64_t generation, std::vector<std::string>& written,
+                      std::string& what)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "'set_pod' stores only the trivially-copyable types");
+  boost::filesystem::path ap;
+  if(!absolutepath(key, false, ap, what))
+  {
+    return false;
+  }
+
+  constexpr cnr::param::utils::pod_header_t header{_pod_fingerprint<T>(), sizeof(T), alignof(T),
+                                                   pod_version<T>::value, 0};
+  cnr::param::utils::EntryWriter entry(ap.string(), cnr::param::utils::payload_t::pod, sizeof(header) + sizeof(T),
+                                        generation);
+  if(!entry)
+  {
+    what = "IMpossible to create the file mapping '" + ap.string() +"'";
+    return false;
+  }
+  std::memcpy(entry.data(), &header, sizeof(header));
+  std::memcpy(entry.data() + sizeof(header), &val, sizeof(T));
+  entry.commit(sizeof(header) + sizeof(T));
+  written.push_back(ap.string());
+
+  auto keys = cnr::param::utils::tokenize(key, "/");
+  boost::filesystem::path root = ap;
+  for(std::size_t i=0; i<keys.size(); i++)
+  {
+    root = root.parent_path();
+  }
+  return cnr::param::utils::patchAncestors(root, keys, generation, written, what);
+}
+
+template<typename T>
+inline bool _set_pod(const std::string& key, const T& val, std::string& what)
+{
+  boost::filesystem::path root;
+  if(!rootpath(root, what))
+  {
+    return false;
+  }
+  cnr::param::utils::GenerationLock lock(root.string());
+  if(!lock)
+  {
+    what = "Impossible to lock the root directory '" + root.string() + "'";
+    return false;
+  }
+
+  std::vector<std::string> written;
+  if(!_set_pod(key, val, lock.next(), written, what))
+  {
+    _discard(written, lock.next());
+    return false;
+  }
+  lock.publish();
+  return true;
+}
+
+template<typename T>
+bool set_pod(const std::string& key, const T& val, std::string& what)
+{
+  return CNR_PARAM_PROBE(set, key, _set_pod(key, val, what));
+}
+
+/**
+ * @brief The blob is copied under the sequence lock of the entry in an aligned buffer, and it is assigned to 'ret'
+ * only once the copy is consistent. The header is checked before copying the bytes, so a mismatched reader costs
+ * only the copy of the header.
+ */
+template<typename T>
+inline bool _get_pod(const std::string& key, T& ret, param_error& err)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "'get_pod' reads only the trivially-copyable types");
+  err.clear();
+  if (!cnr::param::has(key, err))
+  {
+    return false;
+  }
+
+  std::string what;
+  cnr::param::utils::EntryReader entry;
+  if (!cnr::param::recover(key, entry, what))
+  {
+    err.code = error_code_t::storage;
+    err.key = key;
+    err.detail = std::move(what);
+    return false;
+  }
+
+  constexpr std::uint64_t fingerprint = _pod_fingerprint<T>();
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer;
+  std::uint64_t generation = current_generation();
+  int s = -1;
+  error_code_t code = error_code_t::none;
+  while(true)
+  {
+    std::uint64_t seq;
+    do
+    {
+      seq = entry.begin();
+      s = entry.slot(generation);
+      if(s < 0)
+      {
+        continue;
+      }
+      cnr::param::utils::pod_header_t header;
+      if(entry.type(s) != cnr::param::utils::payload_t::pod || entry.size(s) < sizeof(header))
+      {
+        code = error_code_t::not_a_blob;
+        continue;
+      }
+      std::memcpy(&header, entry.data(s), sizeof(header));
+      if(header.fingerprint != fingerprint || header.size != sizeof(T) || entry.size(s) < sizeof(header) + sizeof(T))
+      {
+        code = error_code_t::layout_mismatch;
+        continue;
+      }
+      code = error_code_t::none;
+      std::memcpy(&buffer, entry.data(s) + sizeof(header), sizeof(T));
+    } while(entry.retry(seq));
+
+    if(s >= 0)
+    {
+      break;
+    }
+    // both the versions are newer than the generation, or none has been published yet
+    if(generation == current_generation())
+    {
+      err.code = error_code_t::storage;
+      err.key = key;
+      err.detail = "The param '" + key + "' has not been published yet";
+      return false;
+    }
+    generation = current_generation();
+    CNR_PARAM_COUNT(retry);
+  }
+
+  if(code != error_code_t::none)
+  {
+    err.key = key;
+    err.requested = &typeid(T);
+    return err.fail(code, typeid(T));
+  }
+  std::memcpy(&ret, &buffer, sizeof(T));
+  return true;
+}
+
+template<typename T>
+inline bool get_pod(const std::string& key, T& ret, param_error& err)
+{
+  return CNR_PARAM_PROBE(get, key, _get_pod(key, ret, err));
+}
+
+template<typename T>
+inline bool get_pod(const std::string& key, T& ret, std::string& what)
+{
+  param_error err;
+  if(!get_pod(key, ret, err))
+  {
+    what = err.message();
+    return false;
+  }
+  return true;
+}
+
+template<typename T>
+inline bool Transaction::set(const std::string& key, const T& value, std::string& what)
 {
-  if (!cnr::param::has(key, what))
+  boost::filesystem::path ap;
+  if(!absolutepath(key, false, ap, what))
   {
     return false;
   }
+  staged_.push_back([key, value](std::uint64_t generation, std::vector<std::string>& written, std::string& err)
+  {
+    return CNR_PARAM_PROBE(set, key, cnr::param::_set(key, value, generation, written, err));
+  });
+  return true;
+}
 
-  YAML::Node node;
-  if (!cnr::param::recover(key, node, what))
+inline bool Transaction::commit(std::string& what)
+{
+  if(staged_.empty())
   {
-    return false;
+    return true;
   }
 
-  try
+  boost::filesystem::path root;
+  if(!rootpath(root, what))
   {
-    ret = cnr::param::extract<T>(node);
+    return false;
   }
-  catch (std::exception& e)
+  cnr::param::utils::GenerationLock lock(root.string());
+  if(!lock)
   {
-    what = "Failed in getting the Node struct from parameter '" + key + "':\n";
-    what += e.what();
+    what = "Impossible to lock the root directory '" + root.string() + "'";
     return false;
   }
+
+  std::vector<std::string> written;
+  for(const auto& staged : staged_)
+  {
+    if(!staged(lock.next(), written, what))
+    {
+      _discard(written, lock.next());
+      return false;
+    }
+  }
+  lock.publish();
+  staged_.clear();
   return true;
 }
 
+/**
+ * @brief The payload of a param copied at the generation of the snapshot, and its parsed node
+ */
+struct Snapshot::Cached
+{
+  cnr::param::utils::entry_copy_t copy;
+  std::string path;
+  YAML::Node node;
+  bool parsed = false;
+};
+
+inline Snapshot::Snapshot() : generation_(current_generation())
+{
+}
+
+inline void Snapshot::refresh()
+{
+  generation_ = current_generation();
+  cache_.clear();
+}
+
 template<typename T>
-bool set(const std::string& key, const T& ret, std::string& what)
+inline bool Snapshot::get(const std::string& key, T& ret, std::string& what)
 {
-  boost::filesystem::path ap; 
-  if(!absolutepath(key, false, ap, what))
+  std::shared_ptr<Cached> cached;
+  auto it = cache_.find(key);
+  if(it != cache_.end())
   {
-    return false;
+    cached = it->second;
+    CNR_PARAM_COUNT(snapshot_hit);
+  }
+  else
+  {
+    CNR_PARAM_COUNT(snapshot_miss);
+    cnr::param::utils::EntryReader entry;
+    cached = std::make_shared<Cached>();
+    if(!cnr::param::has(key, what) || !cnr::param::recover(key, entry, what) 
+      || !cnr::param::recover(key, entry, generation_, cached->copy, what))
+    {
+      return false;
+    }
+    cached->path = entry.path();
+    cache_[key] = cached;
   }
 
-  auto keys = cnr::param::utils::tokenize(key, "/");
+  if constexpr(cnr::param::utils::is_binary_matrix<T>::value)
+  {
+    if(cached->copy.type == cnr::param::utils::payload_t::matrix)
+    {
+      std::string err;
+      if(!cnr::param::utils::read_matrix(cached->copy.data.data(), cached->copy.data.size(), _as_matrix(ret), err))
+      {
+        what = "Failed in getting the Node struct from parameter '" + key + "':\n" + err;
+        return false;
+      }
+      return true;
+    }
+  }
 
-  YAML::Node _node;
-  _node[keys.back()] = ret;
+  if(!cached->parsed)
+  {
+    if(!cnr::param::recover(key, cached->copy, cached->path, generation_, cached->node, what))
+    {
+      return false;
+    }
+    cached->parsed = true;
+  }
 
-  std::string str = YAML::Dump(_node);
-  str +="\n";
-  
-  std::size_t fsz = 2 * str.size();
-  auto region = cnr::param::utils::createFileMapping(ap.string(),fsz);
-  if(!region)
+  if constexpr(std::is_same<T, YAML::Node>::value)
   {
-    what = "IMpossible to create the file mapping '" + ap.string() +"'";
-    return false;
+    // the cached node must not be modified through the returned one
+    ret = YAML::Clone(cached->node);
+  }
+  else
+  {
+    param_error err;
+    if(!cnr::param::decode(cached->node, ret, err))
+    {
+      err.key = key;
+      what = err.message();
+      return false;
+    }
   }
-  std::memcpy(region->get_address(), str.c_str(), str.size() );
-  
   return true;
 }
 
@@ -260,23 +993,37 @@ inline bool get(const std::string& key, T& ret, std::string& what, const T& defa
     return true;
   }
 
-  YAML::Node node;
-  if (!cnr::param::recover(key, node, what))
-  {
-    return false;
-  }
+  return cnr::param::get(key, ret, what);
+}
 
-  try
+template<typename T>
+inline bool get(const std::string& key, T& ret, param_error& err, const T& default_val)
+{
+  err.clear();
+  if (!cnr::param::has(key, err))
   {
-    ret = cnr::param::extract<T>(node);
+    if (!cnr::param::utils::resize(ret, default_val))
+    {
+      err.requested = &typeid(T);
+      return err.fail(error_code_t::size_mismatch, typeid(T));
+    }
+    ret = default_val;
+    return true;
   }
-  catch (std::exception& e)
+
+  return cnr::param::get(key, ret, err);
+}
+
+template<typename T>
+inline expected<T> try_get(const std::string& key, const T& default_val)
+{
+  T ret;
+  param_error err;
+  if(!cnr::param::get(key, ret, err, default_val))
   {
-    what = "Failed in getting the Node struct from parameter '" + key + "':\n";
-    what += e.what();
-    return false;
+    return unexpected<param_error>(std::move(err));
   }
-  return true;
+  return ret;
 }
 
 /**
@@ -398,15 +1145,13 @@ inline bool at(const cnr::param::node_t& node, std::size_t i, T& element, std::s
     return false;
   }
 
-  if(node[i].IsScalar())
+  param_error err;
+  if(cnr::param::decode(node[i], element, err))
   {
-    return get_scalar<T>(node[i], element);
+    return true;
   }
-  
-  what = std::string(__PRETTY_FUNCTION__ ) + ":" + std::to_string( __LINE__ ) + ": "
-             "Error in the extraction of the element #" + std::to_string(i) + ". Type of the sequence: "
-              + boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-                + "' but the element is not a scalar type.";
+  err.at(i);
+  what = err.message();
   return false;
 }
 
@@ -466,15 +1211,13 @@ inline bool at(const cnr::param::node_t& node, const std::string& key, T& elemen
   }
   
 
-  if(node[key].IsScalar())
+  param_error err;
+  if(cnr::param::decode(node[key], element, err))
   {
-    return get_scalar<T>(node[key], element);
+    return true;
   }
-  
-  what = std::string(__PRETTY_FUNCTION__ ) + ":" + std::to_string( __LINE__ ) + ": "
-             "Error in the extraction of the element '" + key + "'. Type of the required type: "
-              + boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-                + "' but the element is not a scalar type.";
+  err.key = key;
+  what = err.message();
   return false;
 }
 
@@ -500,67 +1243,75 @@ inline bool at(const cnr::param::node_t& node, const std::string& key, cnr::para
 
 
 
+// ffwd declaration of the dispatch to the decoder selected for T, see below
 template<typename T>
-inline T extract(const YAML::Node& node, const std::string& key, const std::string& error_heading_msgs)
+bool _decode_node(const YAML::Node& node, T& ret, param_error& err);
+
+template<typename T>
+inline bool _decode(const YAML::Node& node, T& ret, param_error& err)
+{
+  err.requested = &typeid(T);
+  return _decode_node(node, ret, err);
+}
+
+template<typename T>
+inline bool decode(const YAML::Node& node, T& ret, param_error& err)
+{
+  return CNR_PARAM_PROBE(extract, std::string(), _decode(node, ret, err));
+}
+
+template<>
+inline bool decode(const YAML::Node& node, YAML::Node& ret, param_error& err)
+{
+  UNUSED(err);
+  ret = node;
+  return true;
+}
+
+template<typename T>
+inline T _extract(const YAML::Node& node, const std::string& key, const std::string& error_heading_msgs)
 {
   T ret;
-  bool ok = false;
-  std::stringstream what;
-  YAML::Node leaf;
-  if(key.length())
+  param_error err;
+  if(key.length() && !node[key])
   {
-    if(node[key])
-    {
-      leaf = node[key];
-      ok = true;
-    }
-    else
-    {
-      what <<(error_heading_msgs.length() ? error_heading_msgs  : 
-          (__PRETTY_FUNCTION__  + std::string(":") + std::to_string(__LINE__) + ": "))
-            << "Tried to extract a ' "
-              << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-                << "' but the type node key '"<< key <<"' is not available" << std::endl
-                  << "Node: " << std::endl
-                    << node << std::endl;
-    }
+    err.requested = &typeid(T);
+    err.key = key;
+    err.fail(error_code_t::missing_key, typeid(T));
   }
-  else
+  else if(cnr::param::decode(key.length() ? YAML::Node(node[key]) : node, ret, err))
   {
-    leaf = node;
-    ok = true;
+    return ret;
   }
 
-  if(ok)
+  throw std::runtime_error((error_heading_msgs.length() ? error_heading_msgs  :
+          (__PRETTY_FUNCTION__  + std::string(":") + std::to_string(__LINE__) + ": ")) + err.message());
+}
+
+template<typename T>
+inline T extract(const YAML::Node& node, const std::string& key, const std::string& error_heading_msgs)
+{
+  return CNR_PARAM_PROBE(extract, key, _extract<T>(node, key, error_heading_msgs));
+}
+
+template<typename T>
+inline expected<T> try_extract(const YAML::Node& node, const std::string& key)
+{
+  T ret;
+  param_error err;
+  // the subscript of a scalar or of a sequence throws: the node is checked before
+  if(key.length() && (!node.IsMap() || !node[key]))
   {
-    if(leaf.IsScalar())
-    {
-      ok = get_scalar(leaf, ret, what);
-    }
-    else if(leaf.IsSequence())
-    {
-      ok = get_sequence(leaf, ret, what);
-    } 
-    else if(leaf.IsMap())
-    {
-      ok = get_map<T>(leaf, ret, what);
-    }
-    else
-    {
-      what
-        <<(error_heading_msgs.length() ? error_heading_msgs  : 
-          (__PRETTY_FUNCTION__  + std::string(":") + std::to_string(__LINE__) + ": "))
-            << "Tried to extract a ' "
-              << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-                << "' but the type node is undefined." << std::endl
-                  << "Node: " << std::endl
-                    << node << std::endl;
-    }
+    err.requested = &typeid(T);
+    err.key = key;
+    const bool not_a_map = node.IsDefined() && !node.IsNull() && !node.IsMap();
+    err.fail(not_a_map ? error_code_t::not_a_map : error_code_t::missing_key, typeid(T));
+    return unexpected<param_error>(std::move(err));
   }
-
-  if(!ok)
+  if(!cnr::param::decode(key.length() ? YAML::Node(node[key]) : node, ret, err))
   {
-    throw std::runtime_error(what.str().c_str());
+    err.key = key;
+    return unexpected<param_error>(std::move(err));
   }
   return ret;
 }
@@ -613,110 +1364,390 @@ inline void insert(node_t& node, const std::string& key, const int& value, const
   }
   else if(format=="hex")
   {
-    val = int_to_hex(value);
+    val = int_to_hex(value);
+  }
+  try
+  {
+    if(key.length())
+    {
+      node[key] = val;
+    }
+    else
+    {
+      node = val;
+    }
+  }
+  catch(const std::exception& e)
+  {
+    throw std::runtime_error(e.what());
+  }
+}
+
+#define CATCH(X)\
+  catch(std::exception& e)\
+  {\
+    CNR_PARAM_LOG_DEBUG(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": "\
+      << "Error in the extraction of an object of type '"\
+        << boost::typeindex::type_id_with_cvr<decltype( X )>().pretty_name() \
+          << "'. What: " << e.what() << std::endl << "Node: " << std::endl << node);\
+    err.fail(error_code_t::bad_conversion, typeid(X));\
+  }
+
+/**
+ * @brief Report the error recorded by a decoder in the stream of the user API
+ */
+inline bool report(const param_error& err, std::stringstream& what)
+{
+  what << err.message() << std::endl;
+  return false;
+}
+
+// =============================================================================================
+// TRAITS
+// =============================================================================================
+template <typename C> struct is_vector : std::false_type {};
+template <typename T,typename A> struct is_vector< std::vector<T,A> > : std::true_type {};
+
+template <typename C> struct is_std_array : std::false_type {};
+template <typename T, std::size_t N> struct is_std_array< std::array<T,N> > : std::true_type {};
+
+template <typename C> struct is_table : std::false_type {};
+template <typename T> struct is_table< cnr::param::Matrix<T> > : std::true_type {};
+
+template <typename C> struct is_associative : std::false_type {};
+template <typename K, typename T, typename C, typename A>
+struct is_associative< std::map<K,T,C,A> > : std::true_type {};
+template <typename K, typename T, typename H, typename E, typename A>
+struct is_associative< std::unordered_map<K,T,H,E,A> > : std::true_type {};
+template <typename K, typename T, typename C, typename A>
+struct is_associative< boost::container::flat_map<K,T,C,A> > : std::true_type {};
+
+template<typename Derived>
+struct is_matrix_expression : std::is_base_of<Eigen::MatrixBase<std::decay_t<Derived> >, std::decay_t<Derived> > {};
+
+/**
+ * @brief The families of types decoded by the library. The family of T is resolved at compile time, so that the
+ * decoder of T is the only one instantiated, and the types that cannot be decoded are rejected by the compiler.
+ */
+enum class decoder_kind_t
+{
+  arithmetic,   // bool, the integers and the floating points
+  string,
+  contiguous,   // std::vector
+  fixed_array,  // std::array
+  eigen_dense,  // the Eigen matrices
+  table,        // cnr::param::Matrix
+  associative,  // std::map, std::unordered_map and boost::container::flat_map
+  user,         // the classes decoded by the specializations of 'get_scalar', 'get_sequence' and 'get_map'
+  unsupported
+};
+
+template<typename T>
+struct decoder_kind : std::integral_constant<decoder_kind_t,
+                        std::is_arithmetic<T>::value          ? decoder_kind_t::arithmetic
+                      : std::is_same<T, std::string>::value   ? decoder_kind_t::string
+                      : is_vector<T>::value                   ? decoder_kind_t::contiguous
+                      : is_std_array<T>::value                ? decoder_kind_t::fixed_array
+                      : is_matrix_expression<T>::value        ? decoder_kind_t::eigen_dense
+                      : is_table<T>::value                    ? decoder_kind_t::table
+                      : is_associative<T>::value              ? decoder_kind_t::associative
+                      : std::is_class<T>::value               ? decoder_kind_t::user
+                      :                                         decoder_kind_t::unsupported> {};
+
+// =============================================================================================
+// BULK NUMBERS
+// =============================================================================================
+/**
+ * @brief The scalar type of the sequences that are read by the bulk parser of the numbers, void for the other types
+ */
+template<typename T, typename = void>
+struct bulk_sequence { using scalar = void; };
+
+template<typename S, typename A>
+struct bulk_sequence<std::vector<S, A>> { using scalar = S; };
+
+template<typename S, typename A, typename B>
+struct bulk_sequence<std::vector<std::vector<S, A>, B>> { using scalar = S; };
+
+template<typename S, std::size_t N>
+struct bulk_sequence<std::array<S, N>> { using scalar = S; };
+
+template<typename S>
+struct bulk_sequence<Matrix<S>> { using scalar = S; };
+
+template<typename Derived>
+struct bulk_sequence<Derived, typename std::enable_if<std::is_base_of<Eigen::MatrixBase<Derived>, Derived>::value>::type>
+{
+  using scalar = typename Derived::Scalar;
+};
+
+template<int Fixed, int Max>
+constexpr bool _fits_eigen_size(std::size_t size)
+{
+  return (Fixed == Eigen::Dynamic || size == static_cast<std::size_t>(Fixed))
+      && (Max == Eigen::Dynamic || size <= static_cast<std::size_t>(Max));
+}
+
+/**
+ * @brief Copy the numbers in 'ret', if their shape is the one expected by the type
+ */
+template<typename S, typename T>
+inline bool _assign_numbers(std::vector<S>& values, const cnr::param::utils::number_shape_t& shape, T& ret)
+{
+  if constexpr(is_std_array<T>::value)
+  {
+    if(shape.nested || values.size() != ret.size())
+    {
+      return false;
+    }
+    std::copy(values.begin(), values.end(), ret.begin());
+    return true;
+  }
+  else if constexpr(is_table<T>::value)
+  {
+    if(!shape.nested)
+    {
+      return false;
+    }
+    ret = Matrix<S>(shape.rows, shape.cols, std::move(values));
+    return true;
+  }
+  else if constexpr(std::is_base_of<Eigen::MatrixBase<T>, T>::value)
+  {
+    constexpr bool row_vector = T::RowsAtCompileTime == 1;
+    if constexpr(T::RowsAtCompileTime == 1 || T::ColsAtCompileTime == 1)
+    {
+      constexpr int size = row_vector ? T::ColsAtCompileTime : T::RowsAtCompileTime;
+      constexpr int max_size = row_vector ? T::MaxColsAtCompileTime : T::MaxRowsAtCompileTime;
+      const std::size_t n = values.size();
+      if(shape.nested || !_fits_eigen_size<size, max_size>(n))
+      {
+        return false;
+      }
+      if constexpr(size == Eigen::Dynamic)
+      {
+        // a view (Map, Block, ...) is not resized, it must have the size of the param: otherwise the YAML decoder
+        // reports the size_mismatch
+        const int dim = static_cast<int>(n);
+        if(!cnr::param::utils::resize(ret, row_vector ? 1 : dim, row_vector ? dim : 1))
+        {
+          return false;
+        }
+      }
+      for(std::size_t i = 0; i < n; i++)
+      {
+        ret.coeffRef(static_cast<Eigen::Index>(i)) = values[i];
+      }
+    }
+    else
+    {
+      if(!shape.nested || !_fits_eigen_size<T::RowsAtCompileTime, T::MaxRowsAtCompileTime>(shape.rows)
+        || !_fits_eigen_size<T::ColsAtCompileTime, T::MaxColsAtCompileTime>(shape.cols))
+      {
+        return false;
+      }
+      if constexpr(T::RowsAtCompileTime == Eigen::Dynamic || T::ColsAtCompileTime == Eigen::Dynamic)
+      {
+        if(!cnr::param::utils::resize(ret, static_cast<int>(shape.rows), static_cast<int>(shape.cols)))
+        {
+          return false;
+        }
+      }
+      for(std::size_t i = 0; i < shape.rows; i++)
+      {
+        for(std::size_t j = 0; j < shape.cols; j++)
+        {
+          ret.coeffRef(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)) = values[i * shape.cols + j];
+        }
+      }
+    }
+    return true;
+  }
+  else if constexpr(is_vector<typename T::value_type>::value)
+  {
+    if(!shape.nested)
+    {
+      return false;
+    }
+    ret.resize(shape.rows);
+    for(std::size_t i = 0; i < shape.rows; i++)
+    {
+      ret[i].assign(values.begin() + i * shape.cols, values.begin() + (i + 1) * shape.cols);
+    }
+    return true;
+  }
+  else
+  {
+    if(shape.nested)
+    {
+      return false;
+    }
+    ret.assign(values.begin(), values.end());
+    return true;
+  }
+}
+
+/**
+ * @brief The sequences of numbers are read without building the YAML nodes: the binary payloads are converted to the
+ * requested scalar type, and the texts are split and converted by the bulk parser. Only the plain sequences and tables
+ * of numbers are accepted: for anything else (e.g., a patched namespace, a special scalar, an unexpected shape, a lossy
+ * conversion) the function returns false, and the caller decodes the YAML node, that reports the errors.
+ */
+template<typename T>
+inline bool _decode_numbers(const std::string& key, const cnr::param::utils::entry_copy_t& copy, T& ret)
+{
+  using S = typename bulk_sequence<T>::scalar;
+  if constexpr(!cnr::param::utils::is_bulk_number<S>::value)
+  {
+    UNUSED(key);
+    UNUSED(copy);
+    UNUSED(ret);
+    return false;
   }
-  try
+  else
   {
-    if(key.length())
+    if(copy.flags & cnr::param::utils::entry_flags::patched)
     {
-      node[key] = val;
+      return false;
+    }
+
+    cnr::param::utils::number_shape_t shape;
+    auto read = [&key, &copy, &shape](std::vector<S>& values)
+    {
+      if(copy.type == cnr::param::utils::payload_t::matrix)
+      {
+        return cnr::param::utils::read_numbers(copy.data.data(), copy.data.size(), values, shape);
+      }
+      const char* begin = nullptr;
+      const char* end = nullptr;
+      return copy.type == cnr::param::utils::payload_t::yaml
+        && cnr::param::utils::payload_value(copy.data, key.substr(key.rfind('/') + 1), begin, end)
+        && cnr::param::utils::parse_numbers(begin, end, values, shape);
+    };
+
+    if constexpr(is_table<T>::value)
+    {
+      std::vector<S> values;  // adopted by the table
+      return read(values) && _assign_numbers(values, shape, ret);
     }
     else
     {
-      node = val;
+      // the scratch buffer is reused by the next reads of the thread, unless a large param made it grow too much
+      constexpr std::size_t max_scratch_size = 1u << 16;
+      thread_local std::vector<S> values;
+      bool ok = read(values);
+      if constexpr(std::is_same<T, std::vector<S>>::value)
+      {
+        // the caller's vector is written only on success, and it lends its storage to the scratch buffer
+        ok = ok && !shape.nested;
+        if(ok)
+        {
+          ret.swap(values);
+        }
+      }
+      else
+      {
+        ok = ok && _assign_numbers(values, shape, ret);
+      }
+      if(values.capacity() > max_scratch_size)
+      {
+        std::vector<S>().swap(values);
+      }
+      return ok;
     }
   }
-  catch(const std::exception& e)
-  {
-    throw std::runtime_error(e.what());
-  }
 }
 
-#define CATCH(X)\
-  catch(YAML::Exception& e)\
-  {\
-      std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "\
-        << "YAML Exception, Error in the extraction of an object of type '"\
-          << boost::typeindex::type_id_with_cvr<decltype( X )>().pretty_name() \
-            << "'" << std::endl\
-              << "Node: " << std::endl\
-                << node << std::endl\
-                  << "What: " << std::endl\
-                    << e.what() << std::endl;\
-    }\
-    catch (std::exception& e)\
-    {\
-      std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "\
-        << "Exception, Error in the extraction of an object of type '"\
-          << boost::typeindex::type_id_with_cvr<decltype( X )>().pretty_name() \
-            << "'" << std::endl\
-              << "Node: " << std::endl\
-                << node << std::endl\
-                  << "What: " << std::endl\
-                    << e.what() << std::endl;\
-    }
-
-
 // =============================================================================================
 // SCALAR
 // =============================================================================================
 template<typename T>
-inline bool _get_scalar(const YAML::Node& node, T& ret, std::stringstream& what)
+inline bool _get_scalar(const YAML::Node& node, T& ret, param_error& err)
 {
-  YAML::Node config(node);
-  if(!config.IsScalar())
+  if(!node.IsScalar())
   {
-    what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-      << "Tried to extract a ' "
-        << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-          << "' but the node is not a scalar." << std::endl
-            << "Node: " << std::endl
-              << node << std::endl;
-    return false;
+    return err.fail(error_code_t::not_a_scalar, typeid(T));
   }
   
-  try
+  if constexpr(cnr::param::utils::is_bulk_number<T>::value)
   {
-    ret = node.as<T>();
-    return true;
+    const std::string& scalar = node.Scalar();
+    if(cnr::param::utils::parse_number(scalar.data(), scalar.data() + scalar.size(), ret))
+    {
+      return true;
+    }
   }
-  CATCH(ret);
-  return false;
+
+  // the conversion of yaml-cpp without the exception that 'as<T>()' throws on failure
+  if(!YAML::convert<T>::decode(node, ret))
+  {
+    return err.fail(error_code_t::bad_conversion, typeid(T));
+  }
+  return true;
 }
 
 template<typename T>
 inline bool get_scalar(const node_t& node, T& ret, std::stringstream& what)
 {
-  UNUSED(node);
-  UNUSED(ret);
-  what << "The type ' " << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-          << "' is not supported. You must specilized your own 'get_scalar' template function";
-  return false;
+  if constexpr(decoder_kind<T>::value == decoder_kind_t::user)
+  {
+    UNUSED(node);
+    UNUSED(ret);
+    what << "The type ' " << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
+            << "' is not supported. You must specilized your own 'get_scalar' template function";
+    return false;
+  }
+  else
+  {
+    param_error err;
+    return decoder<T>::decode(node, ret, err) || report(err, what);
+  }
 }
 
 template<>
 inline bool get_scalar(const YAML::Node& node, double& ret, std::stringstream& what)
 {
-  return _get_scalar<double>(node, ret, what);
+  param_error err;
+  return _get_scalar<double>(node, ret, err) || report(err, what);
 }
 
 template<>
 inline bool get_scalar(const YAML::Node& node, int& ret, std::stringstream& what)
 {
-  return _get_scalar<int>(node, ret, what);
+  param_error err;
+  return _get_scalar<int>(node, ret, err) || report(err, what);
 }
 
 template<>
 inline bool get_scalar(const YAML::Node& node, bool& ret, std::stringstream& what)
 {
-  return _get_scalar<bool>(node, ret, what);
+  param_error err;
+  return _get_scalar<bool>(node, ret, err) || report(err, what);
 }
 
 template<>
 inline bool get_scalar(const YAML::Node& node, std::string& ret, std::stringstream& what)
 {
-  return _get_scalar<std::string>(node, ret, what);
+  param_error err;
+  return _get_scalar<std::string>(node, ret, err) || report(err, what);
+}
+
+/**
+ * @brief The decoders of the library record the error without formatting it; the user decoders, i.e., the
+ * specializations of the functions with the 'std::stringstream', are called with a local stream, that is stored in
+ * the record only if they fail.
+ */
+template<typename T>
+inline bool user_decoder(bool ok, std::stringstream& what, param_error& err)
+{
+  if(!ok)
+  {
+    err.fail(error_code_t::decoder, typeid(T));
+    err.detail = what.str();
+  }
+  return ok;
 }
+
 // =============================================================================================
 // END SCALAR
 // =============================================================================================
@@ -725,322 +1756,454 @@ inline bool get_scalar(const YAML::Node& node, std::string& ret, std::stringstre
 // =============================================================================================
 // SEQUENCE
 // =============================================================================================
-template <typename C> struct is_vector : std::false_type {};
-template <typename T,typename A> struct is_vector< std::vector<T,A> > : std::true_type {};
-
-template<typename Derived>
-struct is_matrix_expression : std::is_base_of<Eigen::MatrixBase<std::decay_t<Derived> >, std::decay_t<Derived> > {};
-
 // ffwd declarations
 template<typename Derived>
-bool _get_sequence_eigen(const YAML::Node& node, Eigen::MatrixBase<Derived> const & ret, std::stringstream& what);
+bool _get_sequence_eigen(const YAML::Node& node, Eigen::MatrixBase<Derived> const & ret, param_error& err);
 
 template<typename T, typename A>
-bool _get_sequence(const YAML::Node& node, std::vector<T, A>& ret, std::stringstream& what);
-
-template<typename T, typename A>
-bool _get_sequence(const YAML::Node& node, std::vector<std::vector<T, A>>& ret, std::stringstream& what);
+bool _get_sequence(const YAML::Node& node, std::vector<T, A>& ret, param_error& err);
 
 template<typename T, std::size_t  N>
-bool _get_sequence(const YAML::Node& node, std::array<T,N>& ret, std::stringstream& what);
+bool _get_sequence(const YAML::Node& node, std::array<T,N>& ret, param_error& err);
 
-template<typename T, std::size_t N, std::size_t M>
-bool _get_sequence(const node_t& node, std::array<std::array<T,M>,N>& ret, std::stringstream& what);
+template<typename T>
+bool _get_sequence(const YAML::Node& node, Matrix<T>& ret, param_error& err);
 
 
 template<typename T, typename A>
-inline bool _get_sequence(const YAML::Node& node, std::vector<T, A>& ret, std::stringstream& what)
+inline bool _get_sequence(const YAML::Node& node, std::vector<T, A>& ret, param_error& err)
 {
-  YAML::Node config(node);
-  if(!config.IsSequence())
+  if(!node.IsSequence())
   {
-    what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": " 
-      << "Tried to extract a ' "
-        << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-          << "' but the node is not a sequence." << std::endl
-            << "Node: " << std::endl
-              << node << std::endl;
-    return false;
+    return err.fail(error_code_t::not_a_sequence, typeid(ret));
   }
   
   try
   {
-    bool ok = false;
     ret.clear();
+    ret.reserve(node.size());
     for(std::size_t i=0; i<node.size();i++)
     {
       T v = T();
-      if(node[i].IsScalar())
-      {
-        ok = get_scalar<T>(node[i], v, what);
-      }
-      else if(node[i].IsSequence())
-      {
-        ok = get_sequence<T>(node[i], v, what);
-      }
-      else if(node[i].IsMap())
-      {
-        ok = get_map<T>(node[i], v, what);
-      }
-
-      if(!ok)
+      if(!_decode_node<T>(node[i], v, err))
       {
-        what  << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-                << "Error in the extraction of the element #" << i << ". Type of the sequence: "
-                  << boost::typeindex::type_id_with_cvr<decltype(std::vector<T>())>().pretty_name() 
-                    << "' but the node is not a sequence." << std::endl
-                      << "Node: " << std::endl
-                        << node << std::endl;
-        break;
+        err.at(i);
+        return false;
       }
-      ret.push_back(v);
+      ret.push_back(std::move(v));
     }
-    return ok;
+    return true;
   }
   CATCH(ret);
   
   return false;
 }
 
-template<typename T, typename A>
-inline bool _get_sequence(const YAML::Node& node, std::vector<std::vector<T, A>>& ret, std::stringstream& what)
+/**
+ * @brief The elements are decoded in place, without temporaries: the nested arrays (e.g., std::array<std::array<T,M>,N>)
+ * are decoded by the same function, so that a fixed-size table is read without any allocation.
+ */
+template<typename T, std::size_t  N>
+inline bool _get_sequence(const YAML::Node& node, std::array<T,N>& ret, param_error& err)
 {
-  bool ok = false;
-  YAML::Node config(node);
-  if(!config.IsSequence())
+  if(!node.IsSequence())
   {
-    what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-      << "Tried to extract a ' "
-        << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-          << "' but the node is not a sequence." << std::endl
-            << "Node: " << std::endl
-              << node << std::endl;
+    return err.fail(error_code_t::not_a_sequence, typeid(ret));
   }
-  else
+  if(node.size() != N)
   {
-    try
-    {
-      ret.clear();
-      for(std::size_t i=0; i<node.size();i++)
-      {
-        if(!config[i].IsSequence())
-        {
-          what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-            << "Tried to extract a ' "
-              << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-                << "' but the node is not a sequence." << std::endl
-                  << "Node: " << std::endl
-                    << config << std::endl;
-        }
-        std::vector<T> v;
-        ok = get_sequence(config[i],v,what);
-        if(!ok)
-        {
-          what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-            << "Error in the extraction of the element #" << i << ". Type of the sequence: "
-              << boost::typeindex::type_id_with_cvr<decltype(std::vector<T>())>().pretty_name() 
-                << "' but the node is not a sequence." << std::endl
-                  << "Node: " << std::endl
-                    << node << std::endl;
-          break;
-        }
-        ret.push_back(v);
-      }
-    }
-    CATCH(ret);
+    err.expected = N;
+    err.actual = node.size();
+    return err.fail(error_code_t::size_mismatch, typeid(ret));
   }
-  return ok;
-}
 
-template<typename T, std::size_t  N>
-bool _get_sequence(const YAML::Node& node, std::array<T,N>& ret, std::stringstream& what)
-{
-  bool ok = false;
-  try
+  for(std::size_t i=0; i<N; i++)
   {
-    std::vector<T> tmp;
-    ok = get_sequence(node,tmp,what);
-    if(!ok || (tmp.size()==N))
-    {
-      what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-        << "Tried to extract a ' "
-          << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-            << "' ?error in size?" << std::endl
-              << "Node: " << std::endl
-                << node << std::endl;
-    }
-    else
+    if(!_decode_node<T>(node[i], ret[i], err))
     {
-      std::copy_n(tmp.begin(), N, ret.begin());
-      ok = true;
+      err.at(i);
+      return false;
     }
   }
-  CATCH(ret);
-
-  return ok;
+  return true;
 }
 
-template<typename T, std::size_t N, std::size_t M>
-bool _get_sequence(const node_t& node, std::array<std::array<T,M>,N>& ret, std::stringstream& what)
+/**
+ * @brief The rows are checked and decoded in a single pass, in the buffer allocated once from the size of the first
+ * row
+ */
+template<typename T>
+inline bool _get_sequence(const YAML::Node& node, Matrix<T>& ret, param_error& err)
 {
-  bool ok = false;
-  try
+  if(!node.IsSequence())
+  {
+    return err.fail(error_code_t::not_a_sequence, typeid(ret));
+  }
+  const std::size_t rows = node.size();
+  if(rows == 0)
+  {
+    ret.resize(0, 0);
+    return true;
+  }
+  const YAML::Node first = node[0];
+  ret.resize(rows, first.IsSequence() ? first.size() : 0);
+
+  for(std::size_t i = 0; i < rows; i++)
   {
-    std::vector<std::vector<T>> tmp;
-    ok = _get_sequence(node, tmp, what);
-    if(!ok || (tmp.size()!=N) || (tmp.front().size()!=M))
+    const YAML::Node row = node[i];
+    if(!row.IsSequence() || row.size() != ret.cols())
     {
-      what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-        << "Tried to extract a ' "
-          << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-            << "' ?error in size?" << std::endl
-              << "Node: " << std::endl
-                << node << std::endl;
+      err.expected = ret.cols();
+      err.actual = row.IsSequence() ? row.size() : 0;
+      err.at(i);
+      return err.fail(row.IsSequence() ? error_code_t::size_mismatch : error_code_t::not_a_sequence, typeid(ret));
     }
-    else
+    T* values = ret.row(i);
+    for(std::size_t j = 0; j < ret.cols(); j++)
     {
-      for(std::size_t i=0;i<N;i++)
+      if(!_decode_node<T>(row[j], values[j], err))
       {
-        std::copy_n(tmp.at(i).begin(), M, ret.at(i).begin());
+        err.at(j);
+        err.at(i);
+        return false;
       }
-      ok = true;
     }
   }
-  CATCH(ret);
+  return true;
+}
 
-  return ok;
+/**
+ * @brief Check the size of the node against the size of the matrix known at compile time (fixed size, or maximum
+ * size). The dynamic sizes are resized by the caller.
+ */
+template<int Fixed, int Max, typename Derived>
+inline bool _check_eigen_size(std::size_t size, param_error& err)
+{
+  if((Fixed != Eigen::Dynamic && size != static_cast<std::size_t>(Fixed))
+      || (Max != Eigen::Dynamic && size > static_cast<std::size_t>(Max)))
+  {
+    err.expected = static_cast<std::size_t>(Fixed != Eigen::Dynamic ? Fixed : Max);
+    err.actual = size;
+    return err.fail(error_code_t::size_mismatch, typeid(Derived));
+  }
+  return true;
 }
 
+/**
+ * @brief The node is decoded straight in the storage of the matrix, with its own scalar type. The shape of the node is
+ * checked against the sizes known at compile time, so that a fixed-size matrix (e.g., Eigen::Matrix<double,6,6>) is
+ * read without any allocation. A vector is read from a sequence, a matrix from a sequence of rows.
+ */
 template<typename Derived>
-inline bool _get_sequence_eigen(const YAML::Node& node, Eigen::MatrixBase<Derived> const & ret, std::stringstream& what)
+inline bool _get_sequence_eigen(const YAML::Node& node, Eigen::MatrixBase<Derived> const & ret, param_error& err)
 {
-  bool ok = false;
+  using Scalar = typename Derived::Scalar;
+  constexpr int rows_at_compile_time = Derived::RowsAtCompileTime;
+  constexpr int cols_at_compile_time = Derived::ColsAtCompileTime;
+  constexpr bool should_be_a_vector = (rows_at_compile_time == 1 || cols_at_compile_time == 1);
   Eigen::MatrixBase<Derived>& _ret = const_cast< Eigen::MatrixBase<Derived>& >(ret);
-  YAML::Node config(node);
 
-  int expected_rows = Eigen::MatrixBase<Derived>::RowsAtCompileTime;
-  int expected_cols = Eigen::MatrixBase<Derived>::ColsAtCompileTime;
-  bool should_be_a_vector = (expected_rows == 1 || expected_cols == 1);
+  if(!node.IsSequence())
+  {
+    return err.fail(error_code_t::not_a_sequence, typeid(Derived));
+  }
 
-  try
+  if constexpr(should_be_a_vector)
   {
-    if (should_be_a_vector)
+    constexpr bool row_vector = rows_at_compile_time == 1;
+    constexpr int size = row_vector ? cols_at_compile_time : rows_at_compile_time;
+    constexpr int max_size = row_vector ? Derived::MaxColsAtCompileTime : Derived::MaxRowsAtCompileTime;
+    const std::size_t n = node.size();
+    if(!_check_eigen_size<size, max_size, Derived>(n, err))
     {
-      std::vector<double> vv;
-      ok = _get_sequence(config, vv, what);
-      if(!ok)
+      return false;
+    }
+    if constexpr(size == Eigen::Dynamic)
+    {
+      // a Map, or a Block, cannot be resized: its size must be the size of the node
+      const int dim = static_cast<int>(n);
+      if(!cnr::param::utils::resize(_ret, row_vector ? 1 : dim, row_vector ? dim : 1))
       {
-        what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-          << "Tried to extract a vector from the "
-                << "Node: " << std::endl
-                  << node << std::endl;
-        return false;
+        err.expected = static_cast<std::size_t>(_ret.size());
+        err.actual = n;
+        return err.fail(error_code_t::size_mismatch, typeid(Derived));
       }
-
-      int dim = static_cast<int>(vv.size());
-      if (!cnr::param::utils::resize(_ret, (expected_rows == 1 ? 1 : dim), (expected_rows == 1 ? dim : 1)))
+    }
+    for(std::size_t i = 0; i < n; i++)
+    {
+      if(!_decode_node<Scalar>(node[i], _ret.coeffRef(static_cast<Eigen::Index>(i)), err))
       {
-        what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-            << "It was expected a Vector (" +
-                                 std::to_string(expected_rows) + "x" + std::to_string(expected_cols) +
-                                 ") while the param store a " + std::to_string(dim) + "-vector" << std::endl
-                << "Node: " << std::endl
-                  << node << std::endl;
+        err.at(i);
         return false;
       }
-      for (int i = 0; i < dim; i++)
+    }
+  }
+  else  // matrix expected
+  {
+    const std::size_t rows = node.size();
+    if(!_check_eigen_size<rows_at_compile_time, Derived::MaxRowsAtCompileTime, Derived>(rows, err))
+    {
+      return false;
+    }
+    std::size_t cols = cols_at_compile_time != Eigen::Dynamic ? static_cast<std::size_t>(cols_at_compile_time) : 0;
+    if(rows > 0)
+    {
+      const YAML::Node first = node[0];
+      if(!first.IsSequence())
       {
-        _ret(i) = vv.at(static_cast<std::size_t>(i));
+        err.at(0);
+        return err.fail(error_code_t::not_a_sequence, typeid(Derived));
       }
+      cols = first.size();
     }
-    else  // matrix expected
+    if(!_check_eigen_size<cols_at_compile_time, Derived::MaxColsAtCompileTime, Derived>(cols, err))
     {
-      std::vector<std::vector<double>> vv;
-      ok = _get_sequence(node, vv, what);
-      if(!ok)
+      return false;
+    }
+    if constexpr(rows_at_compile_time == Eigen::Dynamic || cols_at_compile_time == Eigen::Dynamic)
+    {
+      if(!cnr::param::utils::resize(_ret, static_cast<int>(rows), static_cast<int>(cols)))
       {
-        std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-          << "Tried to extract a vector from the "
-                << "Node: " << std::endl
-                  << node << std::endl;
-        return false;
+        err.expected = static_cast<std::size_t>(_ret.rows());
+        err.actual = rows;
+        return err.fail(error_code_t::size_mismatch, typeid(Derived));
       }
+    }
 
-      int rows = static_cast<int>(vv.size());
-      int cols = static_cast<int>(vv.front().size());
-      if (!cnr::param::utils::resize(_ret, rows, cols))
+    for(std::size_t i = 0; i < rows; i++)
+    {
+      const YAML::Node row = node[i];
+      if(!row.IsSequence() || row.size() != cols)
       {
-        what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-            << "It was expected a Vector (" +
-                                 std::to_string(expected_rows) + "x" + std::to_string(expected_cols) +
-                                 ") while the param store a " + std::to_string(vv.size()) + "-vector" << std::endl
-                << "Node: " << std::endl
-                  << node << std::endl;
-        return false;
+        err.expected = cols;
+        err.actual = row.IsSequence() ? row.size() : 0;
+        err.at(i);
+        return err.fail(row.IsSequence() ? error_code_t::size_mismatch : error_code_t::not_a_sequence,
+                        typeid(Derived));
+      }
+      for(std::size_t j = 0; j < cols; j++)
+      {
+        if(!_decode_node<Scalar>(row[j], _ret.coeffRef(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)),
+                                 err))
+        {
+          err.at(j);
+          err.at(i);
+          return false;
+        }
       }
-      for (int i = 0; i < rows; i++)
-        for (int j = 0; j < cols; j++)
-          _ret(i, j) = vv.at(static_cast<int>(i)).at(static_cast<int>(j));
     }
   }
-  catch (std::exception& e)
+  return true;
+}
+
+template<typename T>
+inline bool get_sequence(const node_t& node, T& ret, std::stringstream& what)
+{
+  if constexpr(decoder_kind<T>::value == decoder_kind_t::user)
+  {
+    UNUSED(node);
+    UNUSED(ret);
+    what << "The type ' " << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
+            << "' is not supported. You must specilized your own 'get_sequence' template function";
+    return false;
+  }
+  else
+  {
+    param_error err;
+    return decoder<T>::decode(node, ret, err) || report(err, what);
+  }
+}
+
+template<typename T>
+inline bool get_map(const node_t& node, T& ret, std::stringstream& what)
+{
+  if constexpr(decoder_kind<T>::value == decoder_kind_t::user)
+  {
+    UNUSED(ret);
+    what<< "The type ' "
+          << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
+            << "' is not supported. You must specilized your own 'get_map' template function" << std::endl
+              << "' Node: " << std::endl
+                << node  << std::endl;
+    return false;
+  }
+  else
   {
-    what << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-        << "Node: " << std::endl
-          << node << std::endl
-            << "What: " << std::endl
-              << e.what() << std::endl;
-    ok = false;
+    param_error err;
+    return decoder<T>::decode(node, ret, err) || report(err, what);
   }
-  catch (...)
+}
+// =============================================================================================
+// END SEQUENCE
+// =============================================================================================
+
+
+// =============================================================================================
+// MAP
+// =============================================================================================
+/**
+ * @brief Decode the pairs of the map node in a single pass, and pass them to 'emplace'. If a key or a value cannot be
+ * decoded, the error records the position and the key of the pair.
+ */
+template<typename K, typename T, typename F>
+inline bool _decode_pairs(const YAML::Node& node, param_error& err, F&& emplace)
+{
+  std::size_t i = 0;
+  for(auto it = node.begin(); it != node.end(); ++it, ++i)
   {
-    what  << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": "
-            << "Node: " << std::endl
-              << node << std::endl
-                << "What: " << std::endl
-                  << "Wrong format" << std::endl;
-    ok = false;
+    K k = K();
+    T v = T();
+    if(!_decode_node<K>(it->first, k, err) || !_decode_node<T>(it->second, v, err))
+    {
+      err.at(i);
+      err.detail = "In the key '" + (it->first.IsScalar() ? it->first.Scalar() : std::string("...")) + "'";
+      return false;
+    }
+    emplace(std::move(k), std::move(v));
   }
   return true;
 }
 
+template<typename K, typename T, typename C, typename A>
+inline bool _get_map(const YAML::Node& node, std::map<K,T,C,A>& ret, param_error& err)
+{
+  if(!node.IsMap())
+  {
+    return err.fail(error_code_t::not_a_map, typeid(ret));
+  }
+  ret.clear();
+  // the hint makes the insertion constant if the keys of the node are sorted
+  return _decode_pairs<K, T>(node, err, [&ret](K&& k, T&& v) {
+    ret.emplace_hint(ret.end(), std::move(k), std::move(v));
+  });
+}
 
-template<typename T>
-inline bool _get_sequence(const node_t& node, T& ret, std::stringstream& what)
+template<typename K, typename T, typename H, typename E, typename A>
+inline bool _get_map(const YAML::Node& node, std::unordered_map<K,T,H,E,A>& ret, param_error& err)
 {
-  if constexpr(is_matrix_expression<T>::value)
+  if(!node.IsMap())
   {
-    return _get_sequence_eigen(node,ret,what);
+    return err.fail(error_code_t::not_a_map, typeid(ret));
   }
-  UNUSED(node);
-  UNUSED(ret);
+  ret.clear();
+  ret.reserve(node.size());
+  return _decode_pairs<K, T>(node, err, [&ret](K&& k, T&& v) { ret.emplace(std::move(k), std::move(v)); });
+}
 
-  what << "The type ' " <<
-      boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-        << "' is not supported. You must specilized your own 'get_sequence' template function";
-  return false;
+template<typename K, typename T, typename C, typename A>
+inline bool _get_map(const YAML::Node& node, boost::container::flat_map<K,T,C,A>& ret, param_error& err)
+{
+  if(!node.IsMap())
+  {
+    return err.fail(error_code_t::not_a_map, typeid(ret));
+  }
+  // the pairs are appended to the storage of the map, that is sorted once at the end
+  auto pairs = ret.extract_sequence();
+  pairs.clear();
+  pairs.reserve(node.size());
+  const bool ok = _decode_pairs<K, T>(node, err, [&pairs](K&& k, T&& v) {
+    pairs.emplace_back(std::move(k), std::move(v));
+  });
+  ret.adopt_sequence(std::move(pairs));
+  return ok;
 }
+// =============================================================================================
+// END MAP
+// =============================================================================================
+
+
+// =============================================================================================
+// DECODERS
+// =============================================================================================
+/**
+ * @brief The decoder of each family of types. The primary template is instantiated only by the unsupported types.
+ */
+template<typename T, decoder_kind_t K = decoder_kind<T>::value>
+struct builtin_decoder
+{
+  static_assert(K != decoder_kind_t::unsupported,
+                "cnr::param cannot decode this type: specialize 'cnr::param::decoder<T>' to register a decoder");
+};
 
 template<typename T>
-inline bool get_sequence(const node_t& node, T& ret, std::stringstream& what)
+struct builtin_decoder<T, decoder_kind_t::arithmetic>
 {
-  return _get_sequence(node, ret, what);
-}
+  static bool decode(const node_t& node, T& ret, param_error& err) { return _get_scalar<T>(node, ret, err); }
+};
 
 template<typename T>
-inline bool get_map(const node_t& node, T& ret, std::stringstream& what)
+struct builtin_decoder<T, decoder_kind_t::string>
 {
-  UNUSED(ret);
-  what<< "The type ' "
-        << boost::typeindex::type_id_with_cvr<decltype(T())>().pretty_name() 
-          << "' is not supported. You must specilized your own 'get_map' template function" << std::endl
-            << "' Node: " << std::endl
-              << node  << std::endl;
-  return false;
+  static bool decode(const node_t& node, T& ret, param_error& err) { return _get_scalar<T>(node, ret, err); }
+};
+
+template<typename T>
+struct builtin_decoder<T, decoder_kind_t::contiguous>
+{
+  static bool decode(const node_t& node, T& ret, param_error& err) { return _get_sequence(node, ret, err); }
+};
+
+template<typename T>
+struct builtin_decoder<T, decoder_kind_t::fixed_array>
+{
+  static bool decode(const node_t& node, T& ret, param_error& err) { return _get_sequence(node, ret, err); }
+};
+
+template<typename T>
+struct builtin_decoder<T, decoder_kind_t::eigen_dense>
+{
+  static bool decode(const node_t& node, T& ret, param_error& err) { return _get_sequence_eigen(node, ret, err); }
+};
+
+template<typename T>
+struct builtin_decoder<T, decoder_kind_t::table>
+{
+  static bool decode(const node_t& node, T& ret, param_error& err) { return _get_sequence(node, ret, err); }
+};
+
+template<typename T>
+struct builtin_decoder<T, decoder_kind_t::associative>
+{
+  static bool decode(const node_t& node, T& ret, param_error& err) { return _get_map(node, ret, err); }
+};
+
+/**
+ * @brief The classes without a registered decoder are decoded by the specializations of 'get_scalar', 'get_sequence'
+ * and 'get_map' with the 'std::stringstream', chosen by the kind of the node
+ */
+template<typename T>
+struct builtin_decoder<T, decoder_kind_t::user>
+{
+  static bool decode(const node_t& node, T& ret, param_error& err)
+  {
+    std::stringstream what;
+    const bool ok = node.IsScalar()   ? get_scalar<T>(node, ret, what)
+                  : node.IsSequence() ? get_sequence<T>(node, ret, what)
+                  :                     get_map<T>(node, ret, what);
+    return user_decoder<T>(ok, what, err);
+  }
+};
+
+template<typename T, typename Enable>
+struct decoder : builtin_decoder<T>
+{
+};
+
+template<typename T>
+inline bool _decode_node(const YAML::Node& node, T& ret, param_error& err)
+{
+  const YAML::NodeType::value type = node.Type();
+  if(type == YAML::NodeType::Undefined || type == YAML::NodeType::Null)
+  {
+    return err.fail(error_code_t::undefined_node, typeid(T));
+  }
+  return decoder<T>::decode(node, ret, err);
 }
+// =============================================================================================
+// END DECODERS
+// =============================================================================================
 
 }
 }
 
 #endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_IMPL_YAML_CNR_PARAM_YAML_CPP_IMPL */
-
@@ -0,0 +1,87 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_MATRIX
+#define CNR_PARAM_INCLUDE_CNR_PARAM_MATRIX
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace cnr
+{
+namespace param
+{
+
+/**
+ * @brief A table of numbers stored row-major in a single buffer. It is decoded from a sequence of rows of the same
+ * size, as std::vector<std::vector<T>>, but with one allocation: the large lookup tables are contiguous, and they can
+ * be passed to the numeric code (e.g., by 'eigen()') without a copy.
+ */
+template<typename T>
+class Matrix
+{
+  static_assert(!std::is_same<T, bool>::value, "cnr::param::Matrix<bool> is not supported, since std::vector<bool> "
+                                               "is not contiguous");
+
+public:
+  using value_type = T;
+
+  Matrix() = default;
+  Matrix(std::size_t rows, std::size_t cols, const T& value = T()) : rows_(rows), cols_(cols), data_(rows * cols, value)
+  {
+  }
+
+  /**
+   * @brief Adopt the buffer of the rows*cols elements, stored row by row
+   */
+  Matrix(std::size_t rows, std::size_t cols, std::vector<T>&& data) : rows_(rows), cols_(cols), data_(std::move(data))
+  {
+    data_.resize(rows * cols);
+  }
+
+  std::size_t rows() const { return rows_; }
+  std::size_t cols() const { return cols_; }
+  std::size_t size() const { return data_.size(); }
+  bool empty() const { return data_.empty(); }
+
+  void resize(std::size_t rows, std::size_t cols)
+  {
+    rows_ = rows;
+    cols_ = cols;
+    data_.resize(rows * cols);
+  }
+
+  T& operator()(std::size_t r, std::size_t c) { return data_[r * cols_ + c]; }
+  const T& operator()(std::size_t r, std::size_t c) const { return data_[r * cols_ + c]; }
+
+  /**
+   * @brief The first element of the row 'r', followed by the other 'cols()' elements of the row
+   */
+  T* row(std::size_t r) { return data_.data() + r * cols_; }
+  const T* row(std::size_t r) const { return data_.data() + r * cols_; }
+
+  T* data() { return data_.data(); }
+  const T* data() const { return data_.data(); }
+
+  /**
+   * @brief The table as an Eigen matrix, without a copy
+   */
+  Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> eigen() const
+  {
+    return {data_.data(), static_cast<Eigen::Index>(rows_), static_cast<Eigen::Index>(cols_)};
+  }
+
+  bool operator==(const Matrix& rhs) const { return rows_ == rhs.rows_ && cols_ == rhs.cols_ && data_ == rhs.data_; }
+  bool operator!=(const Matrix& rhs) const { return !(*this == rhs); }
+
+private:
+  std::size_t rows_ = 0;
+  std::size_t cols_ = 0;
+  std::vector<T> data_;
+};
+
+}  // namespace param
+}  // namespace cnr
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_MATRIX */
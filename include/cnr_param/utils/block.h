@@ -0,0 +1,120 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_BLOCK
+#define CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_BLOCK
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+
+constexpr std::uint32_t block_buffers = 3;
+
+/**
+ * @brief Header of the file of a parameter block. The buffers follow the header, 'stride' bytes each.
+ *
+ * 'front' holds the index of the front buffer in the upper 8 bits, and the count of the readers that pinned it in the
+ * lower 56 bits, so that a reader gets and pins the front buffer with a single fetch_add. When the writer flips the
+ * front, the count of the old front is moved in 'entered', and each reader adds itself to 'left' when it is done: a
+ * back buffer can be rewritten only when 'left' has reached 'entered'.
+ *
+ * While it flips the front, the writer records the old front word in 'flip', and the value of 'entered' that counts its
+ * readers in 'flip_entered': the next writer completes the flip of a writer that died in between.
+ */
+struct block_header_t
+{
+  char                       magic[8];
+  std::uint32_t              version;
+  std::uint32_t              buffers;
+  std::uint64_t              size;         // bytes of the value
+  std::uint64_t              fingerprint;  // layout of the value type
+  std::uint64_t              stride;       // bytes of each buffer, 64-bytes aligned
+  std::atomic<std::uint64_t> lock;         // odd while a writer is filling a back buffer (see 'lockWriter')
+  std::atomic<std::uint64_t> updates;      // values published
+  char                       reserved0[8];
+  std::atomic<std::uint64_t> front;
+  char                       reserved1[56];
+  std::atomic<std::uint64_t> entered[block_buffers];
+  std::atomic<std::uint64_t> left[block_buffers];
+  std::atomic<std::uint64_t> flip;          // the old front word + 1 while the front is flipped, 0 otherwise
+  std::uint64_t              flip_entered;  // 'entered' of the old front after the flip
+};
+static_assert(sizeof(block_header_t) == 192, "The block header must keep the buffers 64-bytes aligned");
+
+/**
+ * @brief The buffers of a parameter block, mapped read-write by the writers and by the readers (the readers pin the
+ * buffer they copy). The readers never wait: 'pin' and 'unpin' are one atomic operation each, and they cannot fail.
+ * The writers are serialized, and a writer waits only if both the back buffers are still pinned by the readers.
+ *
+ * No wait is unbounded: the lock of a writer that died is taken over (see 'lockWriter'), and a buffer pinned by a reader
+ * that died is never released, so the writers use the other ones, and they fail after the timeout if no buffer is left.
+ */
+class BlockBuffer
+{
+public:
+  BlockBuffer() = default;
+  BlockBuffer(const BlockBuffer&) = delete;
+  BlockBuffer& operator=(const BlockBuffer&) = delete;
+  ~BlockBuffer() = default;
+
+  /**
+   * @brief Map the block, or create it if 'create' is true and the file does not exist
+   *
+   * @return false if the block does not exist, or if it stores values of another size or fingerprint
+   */
+  bool open(const std::string& absolute_path, std::size_t size, std::uint64_t fingerprint, bool create,
+              std::string& what);
+
+  explicit operator bool() const { return header_ != nullptr; }
+
+  /**
+   * @brief Copy the value in a back buffer, and make it the front buffer
+   *
+   * @return false if the block is locked by another writer, or if the back buffers are still pinned by the readers,
+   * after 'timeout'
+   */
+  bool write(const void* value, std::chrono::nanoseconds timeout, std::string& what);
+
+  /**
+   * @brief Pin the front buffer, that is not rewritten until 'unpin'
+   *
+   * @return the index of the buffer, to unpin it
+   */
+  std::uint32_t pin() const
+  {
+    return static_cast<std::uint32_t>(header_->front.fetch_add(1, std::memory_order_acq_rel) >> 56);
+  }
+
+  void unpin(std::uint32_t buffer) const
+  {
+    header_->left[buffer].fetch_add(1, std::memory_order_release);
+  }
+
+  const char* data(std::uint32_t buffer) const
+  {
+    return reinterpret_cast<const char*>(header_) + sizeof(block_header_t) + buffer * header_->stride;
+  }
+
+  /**
+   * @brief The values published, 0 if the block has never been written
+   */
+  std::uint64_t updates() const { return header_->updates.load(std::memory_order_acquire); }
+
+private:
+  std::shared_ptr<boost::interprocess::mapped_region> region_;
+  block_header_t* header_ = nullptr;
+};
+
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_BLOCK */
@@ -0,0 +1,63 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_EMITTER
+#define CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_EMITTER
+
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <Eigen/Core>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+
+/**
+ * @brief true for the scalar types that the fast emitter writes with std::to_chars.
+ * The char types are excluded, since yaml-cpp stores them as characters and not as numbers.
+ */
+template<typename T>
+struct is_emittable_scalar : std::integral_constant<bool,
+  std::is_arithmetic<T>::value &&
+    !std::is_same<T, char>::value && !std::is_same<T, signed char>::value && !std::is_same<T, unsigned char>::value>
+{
+};
+
+/**
+ * @brief true if the type can be written by 'emit' without passing through YAML::Dump: scalars, std::vector of
+ * scalars, std::vector of std::vector of scalars, and dense Eigen objects with a scalar coefficient type
+ */
+template<typename T, typename = void>
+struct is_emittable : is_emittable_scalar<T> {};
+
+/**
+ * @brief Upper bound of the number of bytes that 'emit' writes for the pair key/value (terminator excluded)
+ *
+ * @param key
+ * @param value
+ * @return std::size_t
+ */
+template<typename T>
+std::size_t emit_capacity(const std::string& key, const T& value);
+
+/**
+ * @brief Write the YAML text '"key": value' in the buffer [first, last), using the shortest round-trip
+ * representation for the numbers. The output is parsed by YAML::Load as the output of YAML::Dump.
+ *
+ * @param first begin of the destination buffer (e.g., the address of the file mapping)
+ * @param last end of the destination buffer
+ * @param key
+ * @param value
+ * @return std::size_t the number of written bytes, 0 if the buffer is too small
+ */
+template<typename T>
+std::size_t emit(char* first, char* last, const std::string& key, const T& value);
+
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
+
+#include <cnr_param/impl/emitter_impl.h>
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_EMITTER */
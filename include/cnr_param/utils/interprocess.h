@@ -2,6 +2,10 @@
 #define CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_INTERPROCESS
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 
 #include <string>
 #include <istream>
@@ -27,8 +31,10 @@ namespace param
 namespace utils
 {
 
-
-void printMemoryContent(const std::string& header, void* addr, bool check_node);
+/**
+ * @brief Dump of the memory at the debug level of the logger. It is empty if the debug level is not compiled.
+ */
+void printMemoryContent(const std::string& header, const void* addr, std::size_t size, bool check_node);
 
 /**
  * @brief Create a File Mapping object
@@ -38,6 +44,259 @@ void printMemoryContent(const std::string& header, void* addr, bool check_node);
  */
 boost::interprocess::mapped_region* createFileMapping(const std::string& absolute_path, const std::size_t& file_size);
 
+/**
+ * @brief Type of the payload stored in a mapped file
+ */
+enum class payload_t : std::uint32_t
+{
+  none   = 0,
+  yaml   = 1,  // YAML text, i.e., '<leaf-key>: <value>'
+  matrix = 2,  // matrix_header_t followed by the contiguous coefficients (see cnr_param/utils/payload.h)
+  patches = 3, // keys, relative to the entry, of the descendants updated after the entry was written, one per line
+  pod    = 4   // pod_header_t followed by the bytes of a trivially-copyable object (see cnr_param/utils/payload.h)
+};
+
+enum entry_flags : std::uint32_t
+{
+  patched = 0x1  // the descendants listed in the '.patches' entry may be newer than the payload
+};
+
+/**
+ * @brief Descriptor of one of the two payload slots of an entry
+ */
+struct entry_slot_t
+{
+  std::uint64_t generation;  // publication generation of the payload, 0 if the slot is empty
+  std::uint64_t size;        // bytes of the payload
+  std::uint32_t type;        // payload_t
+  std::uint32_t reserved;
+};
+
+/**
+ * @brief Header at the begin of each file mapped by cnr_param. The entry keeps two payloads, the last two versions
+ * written, in the slots that start at offset sizeof(entry_header_t) and sizeof(entry_header_t) + capacity.
+ * A reader gets the newest payload published at its generation (see GenerationLock), so that the payloads staged by a
+ * transaction are not visible until the transaction is published, and a snapshot still reads the previous version.
+ * The slots are protected by a sequence lock: the writers make 'seq' odd while they modify the entry, and the readers
+ * retry if 'seq' changed during their copy. If the writer dies while it holds the lock (see 'lockWriter'), the slot it
+ * was rewriting in place ('writing') is emptied by the next writer, and it is skipped by the readers meanwhile.
+ */
+struct entry_header_t
+{
+  char                       magic[8];
+  std::uint32_t              version;
+  std::uint32_t              flags;     // entry_flags
+  std::uint64_t              capacity;  // bytes available for the payload of each slot
+  std::atomic<std::uint64_t> seq;       // odd while a writer is modifying the entry
+  std::atomic<std::uint32_t> replaced;  // the file has been replaced by a bigger one, and it is no more in use
+  std::uint32_t              writing;   // slot + 1 rewritten in place by the holder of 'seq', 0 if none
+  entry_slot_t               slots[2];
+  char                       reserved[40];
+};
+static_assert(sizeof(entry_header_t) == 128, "The entry header must keep the payload 64-bytes aligned");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "The sequence lock must be address-free");
+
+/**
+ * @brief The lock of the writers of a shared file. The word is odd while a writer holds it, it stores the pid of the
+ * holder in the bits 1-31 and a counter in the upper 32 bits, so that the word changes at each lock and unlock (the
+ * readers of a sequence lock retry if it changed). A holder that is no more running (i.e., 'kill(pid, 0)' fails with
+ * ESRCH) cannot release the lock: the next writer takes it over, changing the counter, and it gets 'recovered' true.
+ * The processes that share the files must see the same pids (e.g., the containers must share the pid namespace).
+ *
+ * @param[in] lock
+ * @param[in] timeout: the longest wait for a running holder, negative to wait until it releases the lock
+ * @param[out] recovered: true if the lock has been taken over from a dead holder
+ * @return false after the timeout
+ */
+bool lockWriter(std::atomic<std::uint64_t>& lock, std::chrono::nanoseconds timeout, bool& recovered);
+void unlockWriter(std::atomic<std::uint64_t>& lock);
+
+/**
+ * @brief false if the word is locked by a process that is no more running
+ */
+bool writerAlive(std::uint64_t lock);
+
+/**
+ * @brief The value of a lock word held by the calling process, to initialize a file that is created locked
+ */
+std::uint64_t lockedWord();
+
+/**
+ * @brief Publication generation of the entries stored under a root directory, kept in '<root>/.generation'.
+ *
+ * @return std::uint64_t the last published generation, the readers see the payloads published up to it
+ */
+std::uint64_t currentGeneration(const std::string& root_directory);
+
+/**
+ * @brief Exclusive write access to the entries under a root directory. The writers stage their payloads with the
+ * generation 'next()', and 'publish' makes all of them visible at once. If the lock is released without publishing,
+ * the staged payloads must be discarded (see 'discardEntry'), since the next writer stages with the same generation.
+ * The lock of a dead writer is taken over (see 'lockWriter'): the payloads it had committed are published with the next
+ * generation, so a transaction interrupted by a crash may be partially published.
+ */
+class GenerationLock
+{
+public:
+  GenerationLock() = delete;
+  GenerationLock(const GenerationLock&) = delete;
+  GenerationLock& operator=(const GenerationLock&) = delete;
+  explicit GenerationLock(const std::string& root_directory);
+  ~GenerationLock();
+
+  explicit operator bool() const { return region_ != nullptr; }
+  std::uint64_t next() const { return next_; }
+  void publish();
+
+private:
+  std::shared_ptr<boost::interprocess::mapped_region> region_;
+  std::uint64_t next_;
+  bool locked_;
+};
+
+/**
+ * @brief Write access to the payload of an entry.
+ *
+ * The payload is written in the slot of the older version (or in the slot already staged with the same generation).
+ * If the entry exists and its capacity fits the required one, the slot is overwritten in place: the mapping is
+ * cached by the process, so that the update is a plain memory write. Otherwise, a new file with a geometrically
+ * grown capacity is filled aside and renamed over the old one by 'commit', so that the readers never see a partially
+ * created file.
+ */
+class EntryWriter
+{
+public:
+  EntryWriter() = delete;
+  EntryWriter(const EntryWriter&) = delete;
+  EntryWriter& operator=(const EntryWriter&) = delete;
+  EntryWriter(const std::string& absolute_path, payload_t type, std::size_t capacity, std::uint64_t generation);
+  ~EntryWriter();
+
+  explicit operator bool() const { return header_ != nullptr; }
+  char* data() { return slotData(target_); }
+  std::size_t capacity() const { return header_ ? header_->capacity : 0; }
+
+  /**
+   * @brief The newest payload of the entry, i.e., the payload staged with the same generation, or the payload in the
+   * other slot. It is used to append data to an entry.
+   */
+  const char* latest(std::size_t& size) const;
+
+  /**
+   * @brief Grow the capacity, keeping the payloads of both the slots.
+   */
+  bool reserve(std::size_t capacity);
+
+  /**
+   * @brief Store the payload size and stage the payload. The writer must not modify the payload after the commit.
+   */
+  void commit(std::size_t size);
+
+  /**
+   * @brief Release the entry without modifying it. The payload must not have been touched.
+   */
+  void cancel();
+
+private:
+  std::string absolute_path_;
+  std::string tmp_path_;
+  std::shared_ptr<boost::interprocess::mapped_region> region_;
+  std::shared_ptr<boost::interprocess::mapped_region> replaced_region_;
+  entry_header_t* header_;
+  std::uint64_t generation_;
+  std::size_t target_;
+  bool committed_;
+
+  char* slotData(std::size_t slot) const 
+  { 
+    return reinterpret_cast<char*>(header_) + sizeof(entry_header_t) + slot * header_->capacity;
+  }
+  bool createTmp(payload_t type, std::size_t capacity, const entry_header_t* copy);
+  void release();
+};
+
+/**
+ * @brief Drop the payload staged with the generation, if any. It rolls back a write that has not been published.
+ */
+bool discardEntry(const std::string& absolute_path, std::uint64_t generation);
+
+/**
+ * @brief Read the flags of an existing entry
+ *
+ * @return false if the entry does not exist
+ */
+bool getEntryFlags(const std::string& absolute_path, std::uint32_t& flags);
+
+/**
+ * @brief Raise the flags of an existing entry, without modifying its payload
+ */
+bool setEntryFlags(const std::string& absolute_path, std::uint32_t flags);
+
+/**
+ * @brief A payload copied from an entry
+ */
+struct entry_copy_t
+{
+  payload_t     type = payload_t::none;
+  std::uint64_t generation = 0;
+  std::uint32_t flags = 0;
+  std::string   data;
+};
+
+/**
+ * @brief Map read-only the file of an entry, and give access to the payload memory.
+ * The payload must be copied between 'begin' and 'retry':
+ *
+ *   std::uint64_t seq;
+ *   do { seq = entry.begin(); int s = entry.slot(generation); ...copy... } while(entry.retry(seq));
+ */
+class EntryReader
+{
+public:
+  EntryReader() = default;
+  EntryReader(const EntryReader&) = delete;
+  EntryReader& operator=(const EntryReader&) = delete;
+  ~EntryReader() = default;
+
+  bool open(const std::string& absolute_path, std::string& what);
+
+  std::uint64_t begin() const;
+  bool retry(std::uint64_t seq) const;
+
+  /**
+   * @brief The slot of the newest payload published up to the generation, -1 if none
+   */
+  int slot(std::uint64_t generation) const;
+
+  /**
+   * @brief true if the entry has been updated twice after the generation, so that its payload at the generation has
+   * been overwritten
+   */
+  bool expired(std::uint64_t generation) const;
+
+  /**
+   * @brief Copy the newest payload published up to the generation
+   *
+   * @return false if none is visible at the generation
+   */
+  bool copy(std::uint64_t generation, entry_copy_t& out) const;
+
+  const std::string& path() const { return path_; }
+  std::uint32_t flags() const { return header_ ? header_->flags : 0; }
+  std::uint64_t generation(int s) const { return header_->slots[s].generation; }
+  payload_t type(int s) const { return static_cast<payload_t>(header_->slots[s].type); }
+  const char* data(int s) const 
+  { 
+    return reinterpret_cast<const char*>(header_) + sizeof(entry_header_t) + s * header_->capacity;
+  }
+  std::size_t size(int s) const { return std::min(header_->slots[s].size, header_->capacity); }
+
+private:
+  std::string path_;
+  std::unique_ptr<boost::interprocess::mapped_region> region_;
+  const entry_header_t* header_ = nullptr;
+};
+
 }  // namespace utils
 }  // namespace param
 }  // namespace cnr 
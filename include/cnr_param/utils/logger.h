@@ -0,0 +1,149 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_LOGGER
+#define CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_LOGGER
+
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <string>
+
+#define CNR_PARAM_LOG_LEVEL_TRACE 0
+#define CNR_PARAM_LOG_LEVEL_DEBUG 1
+#define CNR_PARAM_LOG_LEVEL_INFO  2
+#define CNR_PARAM_LOG_LEVEL_WARN  3
+#define CNR_PARAM_LOG_LEVEL_ERROR 4
+#define CNR_PARAM_LOG_LEVEL_OFF   5
+
+/**
+ * The statements below CNR_PARAM_LOG_ACTIVE_LEVEL are not compiled (cmake -DLOG_ACTIVE_LEVEL=WARN). By default, the
+ * debug statements are compiled only in the debug builds.
+ */
+#if !defined(CNR_PARAM_LOG_ACTIVE_LEVEL)
+#if defined(NDEBUG)
+#define CNR_PARAM_LOG_ACTIVE_LEVEL CNR_PARAM_LOG_LEVEL_INFO
+#else
+#define CNR_PARAM_LOG_ACTIVE_LEVEL CNR_PARAM_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+namespace log
+{
+
+enum class level_t : int
+{
+  trace = CNR_PARAM_LOG_LEVEL_TRACE,
+  debug = CNR_PARAM_LOG_LEVEL_DEBUG,
+  info  = CNR_PARAM_LOG_LEVEL_INFO,
+  warn  = CNR_PARAM_LOG_LEVEL_WARN,
+  error = CNR_PARAM_LOG_LEVEL_ERROR,
+  off   = CNR_PARAM_LOG_LEVEL_OFF
+};
+
+const char* to_string(level_t level);
+
+/**
+ * @brief Messages longer than 'max_message_length' are truncated
+ */
+constexpr std::size_t max_message_length = 1008;
+
+/**
+ * @brief Number of messages that can wait for the drain thread. If the buffer is full, the messages are dropped.
+ */
+constexpr std::size_t queue_capacity = 256;
+
+/**
+ * @brief The runtime threshold. The default is 'warn', or the value of the environment variable CNR_PARAM_LOG_LEVEL
+ * ("trace", "debug", "info", "warn", "error", "off").
+ */
+level_t level();
+void setLevel(level_t level);
+
+inline bool enabled(level_t l)
+{
+  return static_cast<int>(l) >= CNR_PARAM_LOG_ACTIVE_LEVEL && l >= level() && l != level_t::off;
+}
+
+/**
+ * @brief Enqueue the message in the ring buffer, and return immediately. The message is written by a background
+ * thread, started at the first call: the caller never waits for the sink, and it never takes a lock.
+ *
+ * @param level
+ * @param message
+ * @return false if the buffer is full, and the message is dropped
+ */
+bool push(level_t level, const std::string& message);
+
+/**
+ * @brief Wait until the messages enqueued before the call are written. It is called at exit as well.
+ */
+void flush();
+
+/**
+ * @brief Number of messages dropped since the buffer was full
+ */
+std::uint64_t dropped();
+
+/**
+ * @brief The sink is called by the drain thread, in the order of the push. The default sink writes on std::cerr.
+ * An empty function restores the default sink.
+ */
+using sink_t = std::function<void(level_t, const std::string&)>;
+void setSink(sink_t sink);
+
+}  // namespace log
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
+
+/**
+ * The message is a stream expression, evaluated only if the level is enabled:
+ *
+ *   CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": " << e.what());
+ */
+#define CNR_PARAM_LOG(level, ...)                                                         \
+  do                                                                                      \
+  {                                                                                       \
+    if(cnr::param::utils::log::enabled(cnr::param::utils::log::level_t::level))           \
+    {                                                                                     \
+      std::stringstream cnr_param_log_ss__;                                               \
+      cnr_param_log_ss__ << __VA_ARGS__;                                                  \
+      cnr::param::utils::log::push(cnr::param::utils::log::level_t::level, cnr_param_log_ss__.str()); \
+    }                                                                                     \
+  } while (0)
+
+#if CNR_PARAM_LOG_ACTIVE_LEVEL <= CNR_PARAM_LOG_LEVEL_TRACE
+#define CNR_PARAM_LOG_TRACE(...) CNR_PARAM_LOG(trace, __VA_ARGS__)
+#else
+#define CNR_PARAM_LOG_TRACE(...) do {} while (0)
+#endif
+
+#if CNR_PARAM_LOG_ACTIVE_LEVEL <= CNR_PARAM_LOG_LEVEL_DEBUG
+#define CNR_PARAM_LOG_DEBUG(...) CNR_PARAM_LOG(debug, __VA_ARGS__)
+#else
+#define CNR_PARAM_LOG_DEBUG(...) do {} while (0)
+#endif
+
+#if CNR_PARAM_LOG_ACTIVE_LEVEL <= CNR_PARAM_LOG_LEVEL_INFO
+#define CNR_PARAM_LOG_INFO(...) CNR_PARAM_LOG(info, __VA_ARGS__)
+#else
+#define CNR_PARAM_LOG_INFO(...) do {} while (0)
+#endif
+
+#if CNR_PARAM_LOG_ACTIVE_LEVEL <= CNR_PARAM_LOG_LEVEL_WARN
+#define CNR_PARAM_LOG_WARN(...) CNR_PARAM_LOG(warn, __VA_ARGS__)
+#else
+#define CNR_PARAM_LOG_WARN(...) do {} while (0)
+#endif
+
+#if CNR_PARAM_LOG_ACTIVE_LEVEL <= CNR_PARAM_LOG_LEVEL_ERROR
+#define CNR_PARAM_LOG_ERROR(...) CNR_PARAM_LOG(error, __VA_ARGS__)
+#else
+#define CNR_PARAM_LOG_ERROR(...) do {} while (0)
+#endif
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_LOGGER */
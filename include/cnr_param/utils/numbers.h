@@ -0,0 +1,100 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_NUMBERS
+#define CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_NUMBERS
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+
+/**
+ * @brief The parser of the numeric sequences. The text is classified by SIMD instructions (AVX2 or SSE2, selected at
+ * runtime from the CPU), or byte by byte by the portable parser; the digits are converted eight at a time in a 64-bit
+ * register. 'yaml' disables the bulk parser: each scalar is converted by yaml-cpp.
+ */
+enum class number_parser_t : int
+{
+  yaml     = 0,
+  portable = 1,
+  sse      = 2,
+  avx2     = 3
+};
+
+const char* to_string(number_parser_t parser);
+
+/**
+ * @brief The parser in use: the fastest supported by the CPU, or the value of the environment variable
+ * CNR_PARAM_NUMBER_PARSER ("yaml", "portable", "sse", "avx2")
+ */
+number_parser_t numberParser();
+
+/**
+ * @brief Select the parser
+ *
+ * @return false if the CPU does not support it
+ */
+bool setNumberParser(number_parser_t parser);
+
+/**
+ * @brief The types converted by the bulk parser. The other types (bool, the characters) are converted by yaml-cpp.
+ */
+template<typename T>
+struct is_bulk_number : std::integral_constant<bool, (std::is_integral<T>::value || std::is_same<T, float>::value
+                                                       || std::is_same<T, double>::value)
+                                                     && !std::is_same<T, bool>::value
+                                                     && !std::is_same<T, char>::value
+                                                     && !std::is_same<T, signed char>::value
+                                                     && !std::is_same<T, unsigned char>::value
+                                                     && !std::is_same<T, wchar_t>::value
+                                                     && !std::is_same<T, char16_t>::value
+                                                     && !std::is_same<T, char32_t>::value> {};
+
+/**
+ * @brief Convert a plain decimal number (e.g., "-12", "+3.5", ".5", "1e-3").
+ *
+ * @return false if the text is not a plain decimal number (e.g., hexadecimal, octal, ".inf", "1 2"), or if it is out
+ * of the range of T: the caller falls back to the conversion of yaml-cpp, that is the reference of the result and of
+ * the error.
+ */
+template<typename T>
+bool parse_number(const char* begin, const char* end, T& value);
+
+/**
+ * @brief The shape of the parsed sequence: a sequence of numbers, or a sequence of 'rows' rows of 'cols' numbers
+ */
+struct number_shape_t
+{
+  bool        nested = false;
+  std::size_t rows = 0;
+  std::size_t cols = 0;
+};
+
+/**
+ * @brief Split and convert a sequence of plain numbers, written as a flow sequence ("[1, 2, 3]"), as a block sequence
+ * ("- 1\n- 2\n"), or as a sequence of rows of the same size ("[[1, 2], [3, 4]]", "- [1, 2]\n- [3, 4]\n"). The
+ * numbers are stored in 'values', row by row.
+ *
+ * @return false if the text is anything else (a scalar, a map, comments, anchors, ragged rows, quoted or special
+ * scalars, ...): the caller falls back to the YAML parser
+ */
+template<typename T>
+bool parse_numbers(const char* begin, const char* end, std::vector<T>& values, number_shape_t& shape);
+
+/**
+ * @brief The text of the value of the YAML payload '<key>: <value>', as written by 'set' or by the server
+ *
+ * @return false if the payload does not start with the key, or if the value is not a flow or a block sequence
+ */
+bool payload_value(const std::string& payload, const std::string& key, const char*& begin, const char*& end);
+
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_NUMBERS */
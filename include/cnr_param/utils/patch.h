@@ -0,0 +1,57 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_PATCH
+#define CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_PATCH
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+
+/**
+ * @brief Path of the entry that lists the patched descendants of an entry, i.e., '<key>.patches' beside '<key>.yaml'
+ *
+ * @param absolute_path of the entry
+ * @return std::string
+ */
+std::string patchesPath(const std::string& absolute_path);
+
+/**
+ * @brief Record in every ancestor of a key that the key has been updated, so that the readers of the ancestors graft
+ * the value of the key on the stored namespace, if the key is newer than the namespace. The ancestors that do not
+ * exist are created as empty maps. Only the ancestors are touched: the cost is O(depth), whatever the size of the
+ * namespaces.
+ *
+ * @param root the root directory of the server
+ * @param keys the tokens of the updated key
+ * @param generation the generation staged by the writer
+ * @param written the entries staged, to be discarded if the write is rolled back
+ * @param what
+ * @return true
+ * @return false
+ */
+bool patchAncestors(const boost::filesystem::path& root, const std::vector<std::string>& keys, 
+                      std::uint64_t generation, std::vector<std::string>& written, std::string& what);
+
+/**
+ * @brief Read the keys, relative to the entry, of the descendants updated after the entry was written
+ *
+ * @param absolute_path of the entry
+ * @param relative_keys
+ * @param what
+ * @return true
+ * @return false
+ */
+bool readPatches(const std::string& absolute_path, std::vector<std::string>& relative_keys, std::string& what);
+
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_PATCH */
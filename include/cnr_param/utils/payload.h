@@ -0,0 +1,177 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_PAYLOAD
+#define CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_PAYLOAD
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include <Eigen/Core>
+#include <yaml-cpp/yaml.h>
+
+#include <cnr_param/utils/numbers.h>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+
+/**
+ * @brief Type of the coefficients stored in a binary payload
+ */
+enum class scalar_t : std::uint32_t
+{
+  none    = 0,
+  float64 = 1,
+  float32 = 2,
+  int64   = 3,
+  int32   = 4,
+  int16   = 5,
+  uint8   = 6
+};
+
+/**
+ * @brief Header of a 'payload_t::matrix' payload. The coefficients follow the header, contiguous, in the storage
+ * order of the stored object.
+ */
+struct matrix_header_t
+{
+  std::uint32_t scalar;  // scalar_t
+  std::uint32_t flags;   // matrix_flags
+  std::int64_t  rows;
+  std::int64_t  cols;
+  std::uint64_t reserved;
+};
+static_assert(sizeof(matrix_header_t) == 32, "The matrix header must keep the coefficients 32-bytes aligned");
+
+enum matrix_flags : std::uint32_t
+{
+  row_major = 0x1,  // the coefficients are stored row by row
+  vector    = 0x2   // the stored object was a vector at compile time
+};
+
+/**
+ * @brief Header of a 'payload_t::pod' payload. The bytes of the object follow the header.
+ */
+struct pod_header_t
+{
+  std::uint64_t fingerprint;  // hash of the size, the alignment, the name and the version of the type
+  std::uint64_t size;         // bytes of the object
+  std::uint32_t align;
+  std::uint32_t version;      // cnr::param::pod_version of the type
+  std::uint64_t reserved;
+};
+static_assert(sizeof(pod_header_t) == 32, "The POD header must keep the object 32-bytes aligned");
+
+/**
+ * @brief The scalar_t of the type S, 'scalar_t::none' if S cannot be stored in a binary payload
+ */
+template<typename S>
+constexpr scalar_t scalar_type();
+
+/**
+ * @brief true if the Eigen object can be stored in a binary payload
+ */
+template<typename T, typename = void>
+struct is_binary_matrix : std::false_type {};
+
+/**
+ * @brief Bytes of the binary payload of the matrix (header included)
+ *
+ * @param m
+ * @return std::size_t
+ */
+template<typename Derived>
+std::size_t matrix_payload_size(const Eigen::DenseBase<Derived>& m);
+
+/**
+ * @brief Write the header and the coefficients of the matrix in the buffer, that must have at least
+ * 'matrix_payload_size(m)' bytes
+ *
+ * @param data
+ * @param m
+ * @return std::size_t the written bytes
+ */
+template<typename Derived>
+std::size_t write_matrix(char* data, const Eigen::DenseBase<Derived>& m);
+
+/**
+ * @brief Read a binary payload into the matrix. It resizes the matrix if dynamic, and it checks the shape if fixed.
+ * The coefficients are copied with a single memcpy if the scalar type and the storage order match, otherwise they are
+ * converted one by one.
+ *
+ * @param data
+ * @param size
+ * @param ret
+ * @param what
+ * @return true
+ * @return false
+ */
+template<typename Derived>
+bool read_matrix(const char* data, std::size_t size, Eigen::MatrixBase<Derived> const& ret, std::string& what);
+
+/**
+ * @brief Read a binary payload as a sequence of numbers (the vectors) or as a sequence of rows (the matrices). The
+ * numbers are stored in 'values' row by row, converted from the stored scalar type.
+ *
+ * @return false if the payload is corrupted, or if a number cannot be represented in S without loss (e.g., a float32
+ * read as an integer, an int16 read as uint8): the caller falls back to the YAML node, that reports the error
+ */
+template<typename S>
+bool read_numbers(const char* data, std::size_t size, std::vector<S>& values, number_shape_t& shape);
+
+/**
+ * @brief Convert a binary matrix payload in the equivalent YAML node, i.e., a sequence for the vectors and a
+ * sequence of rows for the matrices. It is used by the readers that are not Eigen objects.
+ *
+ * @param data
+ * @param size
+ * @param node
+ * @param what
+ * @return true
+ * @return false
+ */
+bool matrix_to_yaml(const char* data, std::size_t size, YAML::Node& node, std::string& what);
+
+/**
+ * @brief Convert a POD payload in a YAML scalar, i.e., the bytes of the object encoded in base64 (see YAML::Binary).
+ * It is used by the readers that are not 'get_pod'.
+ *
+ * @param data
+ * @param size
+ * @param node
+ * @param what
+ * @return true
+ * @return false
+ */
+bool pod_to_yaml(const char* data, std::size_t size, YAML::Node& node, std::string& what);
+
+/**
+ * @brief The storage annotation of the node, i.e., its YAML tag '!float32', '!int16' or '!uint8'. The annotation of a
+ * map applies to all the numeric sequences it contains.
+ *
+ * @return scalar_t::none if the node is not annotated
+ */
+scalar_t storage_tag(const YAML::Node& node);
+
+/**
+ * @brief Encode a sequence of numbers, or a sequence of rows of numbers of the same size, as a binary payload of the
+ * given scalar type. The integer types accept only the integer numbers in their range.
+ *
+ * @param node
+ * @param scalar
+ * @param payload
+ * @param what empty if the node is not a numeric sequence (e.g., a sequence of strings), the error otherwise
+ * @return true
+ * @return false
+ */
+bool yaml_to_matrix(const YAML::Node& node, scalar_t scalar, std::string& payload, std::string& what);
+
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
+
+#include <cnr_param/impl/payload_impl.h>
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_PAYLOAD */
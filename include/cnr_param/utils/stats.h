@@ -0,0 +1,212 @@
+#ifndef CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_STATS
+#define CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_STATS
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+namespace stats
+{
+
+/**
+ * @brief The instrumented operations of the client API
+ */
+enum class op_t : std::uint32_t
+{
+  has     = 0,
+  recover = 1,  // parse of the payload, and graft of the patched descendants
+  get     = 2,
+  set     = 3,
+  extract = 4,  // conversion of the node in the requested type
+  count   = 5
+};
+
+/**
+ * @brief Events counted without timing
+ */
+enum class counter_t : std::uint32_t
+{
+  snapshot_hit  = 0,  // Snapshot::get served by the cached payload
+  snapshot_miss = 1,  // Snapshot::get that copied the payload from the entry
+  retry         = 2,  // read restarted since the generation moved during the read
+  count         = 3
+};
+
+constexpr const char* op_names[] = {"has", "recover", "get", "set", "extract"};
+constexpr const char* counter_names[] = {"snapshot_hit", "snapshot_miss", "retry"};
+
+/**
+ * @brief Latency histogram: the bucket i counts the calls that lasted [2^i, 2^(i+1)) ns
+ */
+constexpr std::size_t latency_buckets = 32;
+
+struct op_stats_t
+{
+  std::atomic<std::uint64_t> calls;
+  std::atomic<std::uint64_t> errors;
+  std::atomic<std::uint64_t> ns;
+  std::atomic<std::uint64_t> histogram[latency_buckets];
+};
+
+/**
+ * @brief Counters of a thread. Each thread owns a slot, so the counters are not shared among the cores; the threads
+ * exceeding 'max_threads' share the last slot.
+ */
+struct alignas(64) thread_stats_t
+{
+  op_stats_t                 ops[static_cast<std::size_t>(op_t::count)];
+  std::atomic<std::uint64_t> counters[static_cast<std::size_t>(counter_t::count)];
+};
+
+constexpr std::size_t max_key_length = 128;
+
+/**
+ * @brief Counters of a key, shared by all the threads of the process
+ */
+struct alignas(64) key_stats_t
+{
+  std::atomic<std::uint64_t> hash;   // 0 if the slot is free
+  std::atomic<std::uint32_t> ready;  // the key has been written
+  std::uint32_t              reserved;
+  char                       key[max_key_length];  // truncated if longer
+  std::atomic<std::uint64_t> calls[static_cast<std::size_t>(op_t::count)];
+  std::atomic<std::uint64_t> errors[static_cast<std::size_t>(op_t::count)];
+  std::atomic<std::uint64_t> ns[static_cast<std::size_t>(op_t::count)];
+};
+
+constexpr std::size_t max_threads = 64;
+constexpr std::size_t max_keys = 1024;
+
+/**
+ * @brief Stats segment of a process, mapped on '<root>/.stats/<pid>'. It is written only by the process, and it can be
+ * read by any other process (see cnr_param_top) while the process runs: the counters are monotonic, and a reader
+ * computes the rates from two samples.
+ */
+struct stats_segment_t
+{
+  char                       magic[8];
+  std::uint32_t              version;
+  std::int32_t               pid;
+  std::uint64_t              start_ns;  // since the epoch
+  char                       process[64];
+  std::atomic<std::uint32_t> threads;   // slots assigned, it may exceed max_threads
+  std::uint32_t              reserved0;
+  std::atomic<std::uint64_t> dropped;   // calls not accounted per key, since the table of the keys is full
+  char                       reserved[32];
+  thread_stats_t             thread[max_threads];
+  key_stats_t                keys[max_keys];
+};
+
+constexpr std::uint32_t stats_version = 1;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "The counters must be address-free");
+
+/**
+ * @brief Directory of the stats segments of the processes that use the params stored in the root directory
+ *
+ * @param root_directory
+ * @return std::string
+ */
+std::string statsDirectory(const std::string& root_directory);
+
+/**
+ * @brief Check that the mapped memory is a stats segment of the current version
+ *
+ * @param addr
+ * @param size
+ * @return true
+ * @return false
+ */
+bool validSegment(const void* addr, std::size_t size);
+
+/**
+ * @brief Account a call of the operation. The counters of the thread are updated with relaxed atomics, and the
+ * counters of the key, if not empty, are found in an open-addressing table, without locks.
+ * The segment of the process is created at the first call, under the CNR_PARAM_ROOT_DIRECTORY; if the variable is not
+ * set, the calls are not accounted.
+ *
+ * @param op
+ * @param key
+ * @param ns the duration of the call
+ * @param ok
+ */
+void record(op_t op, const std::string& key, std::uint64_t ns, bool ok);
+
+/**
+ * @brief Account an event
+ *
+ * @param counter
+ */
+void count(counter_t counter);
+
+namespace detail
+{
+
+inline bool succeeded(bool ok) { return ok; }
+
+template<typename T>
+inline bool succeeded(const T&) { return true; }
+
+inline std::uint64_t now_ns()
+{
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+}  // namespace detail
+
+/**
+ * @brief Call 'f' and account its duration and its result. The calls returning false, or throwing, are errors.
+ */
+template<typename F>
+inline auto probe(op_t op, const std::string& key, F&& f) -> decltype(f())
+{
+  const std::uint64_t start = detail::now_ns();
+  try
+  {
+    if constexpr(std::is_void<decltype(f())>::value)
+    {
+      f();
+      record(op, key, detail::now_ns() - start, true);
+    }
+    else
+    {
+      auto ret = f();
+      record(op, key, detail::now_ns() - start, detail::succeeded(ret));
+      return ret;
+    }
+  }
+  catch(...)
+  {
+    record(op, key, detail::now_ns() - start, false);
+    throw;
+  }
+}
+
+}  // namespace stats
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
+
+/**
+ * The instrumentation is compiled only if CNR_PARAM_ENABLE_STATS is defined (cmake -DENABLE_STATS=ON), otherwise the
+ * macros expand to the bare expression.
+ */
+#if defined(CNR_PARAM_ENABLE_STATS)
+#define CNR_PARAM_PROBE(op, key, ...) \
+  cnr::param::utils::stats::probe(cnr::param::utils::stats::op_t::op, key, [&]() { return __VA_ARGS__; })
+#define CNR_PARAM_COUNT(counter) cnr::param::utils::stats::count(cnr::param::utils::stats::counter_t::counter)
+#else
+#define CNR_PARAM_PROBE(op, key, ...) (__VA_ARGS__)
+#define CNR_PARAM_COUNT(counter) do {} while (0)
+#endif
+
+#endif  /* CNR_PARAM_INCLUDE_CNR_PARAM_UTILS_STATS */
@@ -37,6 +37,7 @@ private:
   std::map<std::string, std::vector<boost::filesystem::path> > ns_fn_map_;
 
   const std::string default_shmem_id_;
+  std::string trace_file_;
   
 public:
   ArgParser(int argc, const char* const argv[], const std::string& default_shmem_id = "param_server_default_shmem");
@@ -48,6 +49,7 @@ public:
   const std::pair<bool,size_t>& getSizeAll() const;
   const std::map<std::string, size_t>& getSizeMap() const;
   std::map<std::string, std::vector<std::string> > getNamespacesMap() const;
+  const std::string& getTraceFile() const;
 };
 
 #endif  /* SRC_CNR_PARAM_INCLUDE_CNR_PARAM_SERVER_UTILS_ARGS_PARSER */
@@ -0,0 +1,89 @@
+#ifndef SRC_CNR_PARAM_INCLUDE_CNR_PARAM_SERVER_UTILS_TRACE
+#define SRC_CNR_PARAM_INCLUDE_CNR_PARAM_SERVER_UTILS_TRACE
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Spans of the server phases, written as Chrome trace JSON ('chrome://tracing', https://ui.perfetto.dev).
+ * The spans are recorded only if the tracer is enabled (cnr_param_server --trace <file>), otherwise they cost a
+ * branch.
+ */
+class Tracer
+{
+public:
+  struct event_t
+  {
+    std::string name;
+    std::string category;
+    double ts_us;
+    double dur_us;
+    std::size_t tid;
+    std::map<std::string, std::string> args;
+  };
+
+  static Tracer& instance();
+
+  /**
+   * @brief Record the spans, that are written in 'path' by 'flush'. An empty path disables the tracer, and it
+   * discards the recorded spans.
+   */
+  void enable(const std::string& path);
+  bool enabled() const { return enabled_; }
+
+  /**
+   * @brief Microseconds since the start of the process
+   */
+  double now_us() const;
+
+  /**
+   * @brief Id of the calling thread in the trace
+   */
+  static std::size_t thread_id();
+
+  void add(event_t&& event);
+
+  /**
+   * @brief Write the recorded spans in the trace file
+   *
+   * @param what
+   * @return true
+   * @return false
+   */
+  bool flush(std::string& what);
+
+private:
+  Tracer();
+  bool enabled_;
+  std::string path_;
+  std::chrono::steady_clock::time_point start_;
+  std::mutex mtx_;
+  std::vector<event_t> events_;
+};
+
+/**
+ * @brief Span from the construction to the destruction of the object
+ */
+class TraceSpan
+{
+public:
+  TraceSpan() = delete;
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+  TraceSpan(const char* name, const char* category);
+  ~TraceSpan();
+
+  /**
+   * @brief Argument of the span, shown by the trace viewer when the span is selected
+   */
+  TraceSpan& arg(const std::string& name, const std::string& value);
+
+private:
+  bool enabled_;
+  Tracer::event_t event_;
+};
+
+#endif  /* SRC_CNR_PARAM_INCLUDE_CNR_PARAM_SERVER_UTILS_TRACE */
@@ -1,6 +1,7 @@
 #ifndef SRC_CNR_PARAM_INCLUDE_CNR_PARAM_SERVER_YAML_MANAGER
 #define SRC_CNR_PARAM_INCLUDE_CNR_PARAM_SERVER_YAML_MANAGER
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -32,6 +33,8 @@ public:
 private:
   //std::map< std::string, boost::interprocess::managed_mapped_file > shd_file_;
   YAML::Node root_;
+  std::uint64_t generation_;
+  std::vector<std::string> written_;
   bool streamLeaf(const std::string& absolute_root_path);
   bool streamNodes(const std::string& absolute_root_path);
 };
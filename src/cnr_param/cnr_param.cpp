@@ -1,3 +1,7 @@
+#include <sstream>
+
+#include <boost/type_index.hpp>
+
 #include "cnr_param/cnr_param.h"
 
 namespace cnr
@@ -5,5 +9,71 @@ namespace cnr
 namespace param
 {
 
+const char* to_string(error_code_t code)
+{
+  switch(code)
+  {
+    case error_code_t::none:             return "no error";
+    case error_code_t::missing_key:      return "the key is not available";
+    case error_code_t::undefined_node:   return "the node is undefined";
+    case error_code_t::not_a_scalar:     return "the node is not a scalar";
+    case error_code_t::not_a_sequence:   return "the node is not a sequence";
+    case error_code_t::not_a_map:        return "the node is not a map";
+    case error_code_t::bad_conversion:   return "the scalar cannot be converted";
+    case error_code_t::size_mismatch:    return "the size of the sequence is wrong";
+    case error_code_t::unsupported_type: return "the type is not supported, you must specialize your own 'decoder', "
+                                                "'get_scalar', 'get_sequence' or 'get_map' template function";
+    case error_code_t::decoder:          return "the decoder failed";
+    case error_code_t::storage:          return "the param cannot be read";
+    case error_code_t::not_a_blob:       return "the param is not a POD blob";
+    case error_code_t::layout_mismatch:  return "the layout of the POD blob is not the one of the type";
+  }
+  return "unknown error";
+}
+
+std::string param_error::message() const
+{
+  if(code == error_code_t::none)
+  {
+    return std::string();
+  }
+
+  std::stringstream what;
+  if(!key.empty())
+  {
+    what << "Failed in getting the param '" << key << "'";
+  }
+  else
+  {
+    what << "Failed in decoding the node";
+  }
+  if(requested)
+  {
+    what << " as '" << boost::typeindex::type_index(*requested).pretty_name() << "'";
+  }
+  what << ": " << to_string(code);
+  if(type && (!requested || *type != *requested))
+  {
+    what << " (element of type '" << boost::typeindex::type_index(*type).pretty_name() << "')";
+  }
+  if(depth > 0)
+  {
+    what << " at the element " << (truncated ? "[...]" : "");
+    for(std::size_t d = 0; d < depth; d++)
+    {
+      what << "[" << index[d] << "]";
+    }
+  }
+  if(code == error_code_t::size_mismatch)
+  {
+    what << ", expected " << expected << " elements while the node has " << actual;
+  }
+  if(!detail.empty())
+  {
+    what << "\n" << detail;
+  }
+  return what.str();
+}
+
 }  // namespace param
 }  // namespace cnr
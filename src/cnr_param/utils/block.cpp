@@ -0,0 +1,188 @@
+#include <cstring>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+
+#include <cnr_param/utils/block.h>
+#include <cnr_param/utils/interprocess.h>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+
+namespace
+{
+const char block_magic[8] = {'C', 'N', 'R', 'P', 'B', 'L', 'K', '\0'};
+const std::uint32_t block_version = 3;
+constexpr std::uint64_t front_readers = (std::uint64_t(1) << 56) - 1;
+
+/**
+ * @brief Create the file of the block aside, and link it, so that the concurrent creators agree on the same file
+ */
+bool createBlock(const std::string& absolute_path, std::size_t size, std::uint64_t fingerprint, std::string& what)
+{
+  static std::atomic<std::uint64_t> tmp_counter(0);
+  const std::string tmp_path = absolute_path + ".tmp."
+    + std::to_string(boost::interprocess::ipcdetail::get_current_process_id()) + "." + std::to_string(tmp_counter++);
+
+  const std::uint64_t stride = (size + 63) / 64 * 64;
+  std::unique_ptr<boost::interprocess::mapped_region> tmp(
+    createFileMapping(tmp_path, sizeof(block_header_t) + block_buffers * stride));
+  if(!tmp)
+  {
+    what = "Impossible to create the file mapping '" + tmp_path + "'";
+    return false;
+  }
+  block_header_t* header = static_cast<block_header_t*>(tmp->get_address());
+  std::memcpy(header->magic, block_magic, sizeof(block_magic));
+  header->version = block_version;
+  header->buffers = block_buffers;
+  header->size = size;
+  header->fingerprint = fingerprint;
+  header->stride = stride;
+  header->lock.store(0, std::memory_order_relaxed);
+  header->updates.store(0, std::memory_order_relaxed);
+  header->front.store(0, std::memory_order_relaxed);
+  for(std::uint32_t b = 0; b < block_buffers; b++)
+  {
+    header->entered[b].store(0, std::memory_order_relaxed);
+    header->left[b].store(0, std::memory_order_relaxed);
+  }
+  header->flip.store(0, std::memory_order_relaxed);
+  header->flip_entered = 0;
+  tmp.reset();
+
+  boost::system::error_code ec;
+  boost::filesystem::create_hard_link(tmp_path, absolute_path, ec);
+  boost::filesystem::remove(tmp_path, ec);
+  return true;
+}
+
+}  // namespace
+
+bool BlockBuffer::open(const std::string& absolute_path, std::size_t size, std::uint64_t fingerprint, bool create,
+                        std::string& what)
+{
+  header_ = nullptr;
+  try
+  {
+    if(!boost::filesystem::exists(absolute_path))
+    {
+      if(!create)
+      {
+        what = "The block '" + absolute_path + "' has not been published yet";
+        return false;
+      }
+      if(!createBlock(absolute_path, size, fingerprint, what))
+      {
+        return false;
+      }
+    }
+    boost::interprocess::file_mapping file(absolute_path.c_str(), boost::interprocess::read_write);
+    region_ = std::make_shared<boost::interprocess::mapped_region>(file, boost::interprocess::read_write);
+  }
+  catch(std::exception& e)
+  {
+    what = "Impossible to map the block '" + absolute_path + "': " + e.what();
+    return false;
+  }
+
+  block_header_t* header = static_cast<block_header_t*>(region_->get_address());
+  if(region_->get_size() < sizeof(block_header_t)
+    || std::memcmp(header->magic, block_magic, sizeof(block_magic)) != 0
+      || header->version != block_version || header->buffers != block_buffers
+        || header->stride < header->size
+          || region_->get_size() < sizeof(block_header_t) + block_buffers * header->stride)
+  {
+    what = "The file '" + absolute_path + "' is not a valid cnr_param block";
+    return false;
+  }
+  if(header->size != size || header->fingerprint != fingerprint)
+  {
+    what = "The block '" + absolute_path + "' stores the values of another type";
+    return false;
+  }
+  header_ = header;
+  return true;
+}
+
+bool BlockBuffer::write(const void* value, std::chrono::nanoseconds timeout, std::string& what)
+{
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+  // The writers are serialized by the odd values of 'lock', as the writers of the entries. The lock of a dead writer is
+  // taken over: it was filling a back buffer, that is not visible to the readers, or it was flipping the front
+  bool recovered = false;
+  if(!lockWriter(header_->lock, timeout, recovered))
+  {
+    what = "The block is locked by another writer";
+    return false;
+  }
+
+  // The index of the front is modified only by the writers, while the readers modify only its count
+  const std::uint32_t front = static_cast<std::uint32_t>(header_->front.load(std::memory_order_relaxed) >> 56);
+  const std::uint64_t flip = recovered ? header_->flip.load(std::memory_order_acquire) : 0;
+  if(flip)
+  {
+    // The dead writer flipped the front, but it may have not counted the readers of the old one: 'entered' is stored
+    // again, since the store is idempotent
+    const std::uint32_t old_front = static_cast<std::uint32_t>((flip - 1) >> 56);
+    if(old_front != front)
+    {
+      header_->entered[old_front].store(header_->flip_entered, std::memory_order_relaxed);
+    }
+    header_->flip.store(0, std::memory_order_relaxed);
+  }
+  std::uint32_t back = block_buffers;
+  while(back == block_buffers)
+  {
+    for(std::uint32_t b = 1; b < block_buffers; b++)
+    {
+      const std::uint32_t candidate = (front + b) % block_buffers;
+      if(header_->left[candidate].load(std::memory_order_acquire)
+        == header_->entered[candidate].load(std::memory_order_relaxed))
+      {
+        back = candidate;
+        break;
+      }
+    }
+    if(back == block_buffers)
+    {
+      if(std::chrono::steady_clock::now() > deadline)
+      {
+        unlockWriter(header_->lock);
+        what = "The back buffers of the block are still pinned by the readers";
+        return false;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  std::memcpy(reinterpret_cast<char*>(header_) + sizeof(block_header_t) + back * header_->stride, value,
+              header_->size);
+
+  // The flip is recorded before the front is replaced, with the exact word that the compare-exchange replaces, so that
+  // the count of the readers of the old front is never lost (see 'flip' in block_header_t)
+  const std::uint64_t entered = header_->entered[front].load(std::memory_order_relaxed);
+  std::uint64_t old = header_->front.load(std::memory_order_relaxed);
+  do
+  {
+    header_->flip_entered = entered + (old & front_readers);
+    header_->flip.store(old + 1, std::memory_order_relaxed);
+  } while(!header_->front.compare_exchange_weak(old, std::uint64_t(back) << 56, std::memory_order_acq_rel,
+                                                  std::memory_order_relaxed));
+  header_->entered[front].store(header_->flip_entered, std::memory_order_relaxed);
+  header_->flip.store(0, std::memory_order_release);
+  header_->updates.fetch_add(1, std::memory_order_release);
+  unlockWriter(header_->lock);
+  return true;
+}
+
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
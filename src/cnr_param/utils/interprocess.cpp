@@ -1,9 +1,24 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <functional>
+#include <limits>
+#include <list>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <signal.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/interprocess/detail/os_thread_functions.hpp>
 
 #include <cnr_param/utils/string.h>
 #include <cnr_param/utils/filesystem.h>
 #include <cnr_param/utils/interprocess.h>
+#include <cnr_param/utils/logger.h>
 
 namespace cnr 
 {
@@ -12,24 +27,28 @@ namespace param
 namespace utils
 {
 
-void printMemoryContent(const std::string& header, void* addr, bool check_node)
+void printMemoryContent(const std::string& header, const void* addr, std::size_t size, bool check_node)
 {
-  //Check that memory was initialized to 1
-  const char *mem = static_cast<char*>(addr);
-  std::string strmem(mem);
-
-  std::cout << "^^^^^^^^^^^^^^^^^^^^" << std::endl;
-  std::cout << header << std::endl;
-  std::cout << strmem << std::endl;
-  std::cout << "^^^^^^^^^^^^^^^^^^^^" << std::endl;
+#if CNR_PARAM_LOG_ACTIVE_LEVEL > CNR_PARAM_LOG_LEVEL_DEBUG
+  static_cast<void>(header);
+  static_cast<void>(addr);
+  static_cast<void>(size);
+  static_cast<void>(check_node);
+#else
+  if(!log::enabled(log::level_t::debug))
+  {
+    return;
+  }
+  const char *mem = static_cast<const char*>(addr);
+  std::string strmem(mem, size);
 
+  CNR_PARAM_LOG_DEBUG(header << "\n" << strmem);
   if(check_node)
   {
     auto n = YAML::Load(strmem);
-    std::cout << "key: " << n.begin()->first << std::endl;
-    std::cout << "value: " << n.begin()->second << std::endl;
-    std::cout << "^^^^^^^^^^^^^^^^^^^^" << std::endl;
+    CNR_PARAM_LOG_DEBUG(header << "\nkey: " << n.begin()->first << "\nvalue: " << n.begin()->second);
   }
+#endif
 }
 
 boost::interprocess::mapped_region* createFileMapping(const std::string& absolute_path, const std::size_t& file_size)
@@ -84,27 +103,725 @@ boost::interprocess::mapped_region* createFileMapping(const std::string& absolut
   }
   catch(boost::interprocess::lock_exception& e)
   {
-    std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << absolute_path << std::endl;
-    std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": last executed line " << l << ":" << e.what() << std::endl;
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << absolute_path
+      << ", last executed line " << l << ": " << e.what());
   }
   catch(boost::interprocess::bad_alloc& e)
   {
-    std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << absolute_path << std::endl;
-    std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": last executed line " << l << ":" << e.what() << std::endl;
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << absolute_path
+      << ", last executed line " << l << ": " << e.what());
   }
   catch(boost::interprocess::interprocess_exception& e)
   {
-    std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << absolute_path << std::endl;
-    std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": last executed line " << l << ":" << e.what() << std::endl;
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << absolute_path
+      << ", last executed line " << l << ": " << e.what());
   }
   catch(std::exception& e)
   {
-    std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << absolute_path << std::endl;
-    std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": last executed line " << l << ":" << e.what() << std::endl;
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << absolute_path
+      << ", last executed line " << l << ": " << e.what());
   }
   return nullptr;
 }
 
+namespace
+{
+const char entry_magic[8] = {'C', 'N', 'R', 'P', 'A', 'R', 'A', 'M'};
+const std::uint32_t entry_version = 4;
+const char generation_magic[8] = {'C', 'N', 'R', 'P', 'G', 'E', 'N', '\0'};
+
+/**
+ * @brief Content of '<root>/.generation'
+ */
+struct generation_header_t
+{
+  char                       magic[8];
+  std::uint32_t              version;
+  std::uint32_t              reserved0;
+  std::atomic<std::uint64_t> lock;     // odd while a writer owns the root directory
+  std::atomic<std::uint64_t> current;  // last published generation
+  char                       reserved[32];
+};
+static_assert(sizeof(generation_header_t) == 64, "The generation header must fill a cache line");
+
+bool validHeader(const entry_header_t* header, std::size_t region_size)
+{
+  return region_size >= sizeof(entry_header_t)
+    && std::memcmp(header->magic, entry_magic, sizeof(entry_magic)) == 0
+      && header->version == entry_version
+        && header->capacity <= (region_size - sizeof(entry_header_t)) / 2;
+}
+
+void lockEntry(entry_header_t* header)
+{
+  bool recovered = false;
+  lockWriter(header->seq, std::chrono::nanoseconds(-1), recovered);
+  if(recovered && header->writing)
+  {
+    // the dead writer was rewriting a slot in place: its payload is not consistent
+    header->slots[header->writing - 1].generation = 0;
+    header->slots[header->writing - 1].size = 0;
+    CNR_PARAM_LOG_WARN("A writer died while it was writing an entry: the version it was writing has been discarded");
+  }
+  header->writing = 0;
+}
+
+void unlockEntry(entry_header_t* header)
+{
+  header->writing = 0;
+  unlockWriter(header->seq);
+}
+
+/**
+ * @brief The read-write mappings of the entries written by this process. They are reused by the next writes, until
+ * the file is replaced. The cache keeps the most recently written entries only, so that a process that writes many
+ * entries (e.g., the server loading a large configuration) does not keep a mapping of each of them.
+ */
+constexpr std::size_t writer_mappings_capacity = 1024;
+
+struct WriterMapping
+{
+  std::shared_ptr<boost::interprocess::mapped_region> region;
+  dev_t dev;
+  ino_t ino;
+  std::list<std::string>::iterator lru;
+};
+
+struct WriterMappings
+{
+  std::mutex mtx;
+  std::unordered_map<std::string, WriterMapping> regions;
+  std::list<std::string> lru;  // the most recently used first
+
+  void store(const std::string& absolute_path, const std::shared_ptr<boost::interprocess::mapped_region>& region,
+               dev_t dev, ino_t ino)
+  {
+    auto it = regions.find(absolute_path);
+    if(it != regions.end())
+    {
+      lru.erase(it->second.lru);
+      regions.erase(it);
+    }
+    lru.push_front(absolute_path);
+    regions[absolute_path] = WriterMapping{region, dev, ino, lru.begin()};
+    if(regions.size() > writer_mappings_capacity)
+    {
+      regions.erase(lru.back());
+      lru.pop_back();
+    }
+  }
+
+  void erase(std::unordered_map<std::string, WriterMapping>::iterator it)
+  {
+    lru.erase(it->second.lru);
+    regions.erase(it);
+  }
+};
+
+WriterMappings& writerMappings()
+{
+  static WriterMappings mappings;
+  return mappings;
+}
+
+/**
+ * @brief The identity of the file at the path, to detect that it has been unlinked or replaced
+ */
+bool fileId(const std::string& absolute_path, dev_t& dev, ino_t& ino)
+{
+  struct stat st;
+  if(::stat(absolute_path.c_str(), &st) != 0)
+  {
+    return false;
+  }
+  dev = st.st_dev;
+  ino = st.st_ino;
+  return true;
+}
+
+std::shared_ptr<boost::interprocess::mapped_region> writerMapping(const std::string& absolute_path, bool refresh)
+{
+  WriterMappings& mappings = writerMappings();
+  std::lock_guard<std::mutex> lock(mappings.mtx);
+  dev_t dev = 0;
+  ino_t ino = 0;
+  const bool exists = fileId(absolute_path, dev, ino);
+  auto it = mappings.regions.find(absolute_path);
+  if(it != mappings.regions.end())
+  {
+    // a mapping of a file that has been unlinked or replaced by another process is never reused
+    if(!refresh && exists && it->second.dev == dev && it->second.ino == ino)
+    {
+      mappings.lru.splice(mappings.lru.begin(), mappings.lru, it->second.lru);
+      return it->second.region;
+    }
+    mappings.erase(it);
+  }
+
+  std::shared_ptr<boost::interprocess::mapped_region> region;
+  try
+  {
+    if(exists)
+    {
+      boost::interprocess::file_mapping file(absolute_path.c_str(), boost::interprocess::read_write);
+      region = std::make_shared<boost::interprocess::mapped_region>(file, boost::interprocess::read_write);
+      if(!validHeader(static_cast<entry_header_t*>(region->get_address()), region->get_size()))
+      {
+        region.reset();
+      }
+    }
+  }
+  catch(std::exception&)
+  {
+    region.reset();
+  }
+
+  // the identity is read again after the mapping, in case the file has been replaced meanwhile
+  if(region && fileId(absolute_path, dev, ino))
+  {
+    mappings.store(absolute_path, region, dev, ino);
+  }
+  return region;
+}
+
+void storeWriterMapping(const std::string& absolute_path,
+                          const std::shared_ptr<boost::interprocess::mapped_region>& region)
+{
+  WriterMappings& mappings = writerMappings();
+  std::lock_guard<std::mutex> lock(mappings.mtx);
+  dev_t dev = 0;
+  ino_t ino = 0;
+  if(fileId(absolute_path, dev, ino))
+  {
+    mappings.store(absolute_path, region, dev, ino);
+  }
+}
+
+/**
+ * @brief The locked, not replaced, mapping of an existing entry
+ */
+std::shared_ptr<boost::interprocess::mapped_region> lockedWriterMapping(const std::string& absolute_path)
+{
+  std::shared_ptr<boost::interprocess::mapped_region> region = writerMapping(absolute_path, false);
+  while(region)
+  {
+    entry_header_t* header = static_cast<entry_header_t*>(region->get_address());
+    lockEntry(header);
+    if(!header->replaced.load(std::memory_order_acquire))
+    {
+      break;
+    }
+    unlockEntry(header);
+    region = writerMapping(absolute_path, true);
+  }
+  return region;
+}
+
+std::string tmpPath(const std::string& absolute_path)
+{
+  static std::atomic<std::uint64_t> tmp_counter(0);
+  return absolute_path + ".tmp." + std::to_string(boost::interprocess::ipcdetail::get_current_process_id()) 
+    + "." + std::to_string(tmp_counter++);
+}
+
+struct GenerationMapping
+{
+  std::shared_ptr<boost::interprocess::mapped_region> region;
+  dev_t dev;
+  ino_t ino;
+};
+
+/**
+ * @brief The mapping of '<root>/.generation', created if it does not exist. The mapping is cached by the process, as
+ * long as the file is not unlinked or replaced (e.g., when the root directory is cleaned).
+ */
+std::shared_ptr<boost::interprocess::mapped_region> generationMapping(const std::string& root_directory)
+{
+  static std::mutex mtx;
+  static std::unordered_map<std::string, GenerationMapping> regions;
+
+  const std::string absolute_path = (boost::filesystem::path(root_directory) / ".generation").string();
+  std::lock_guard<std::mutex> lock(mtx);
+  dev_t dev = 0;
+  ino_t ino = 0;
+  const bool exists = fileId(absolute_path, dev, ino);
+  auto it = regions.find(root_directory);
+  if(it != regions.end())
+  {
+    if(exists && it->second.dev == dev && it->second.ino == ino)
+    {
+      return it->second.region;
+    }
+    regions.erase(it);
+  }
+
+  std::shared_ptr<boost::interprocess::mapped_region> region;
+  try
+  {
+    if(!exists)
+    {
+      // The file is filled aside and linked, so that the concurrent creators agree on the same file. The generations
+      // start from the creation time, so that they keep increasing even if the root directory is cleaned.
+      std::string tmp_path = tmpPath(absolute_path);
+      std::unique_ptr<boost::interprocess::mapped_region> tmp(createFileMapping(tmp_path, sizeof(generation_header_t)));
+      if(!tmp)
+      {
+        return nullptr;
+      }
+      generation_header_t* header = static_cast<generation_header_t*>(tmp->get_address());
+      std::memcpy(header->magic, generation_magic, sizeof(generation_magic));
+      header->version = entry_version;
+      header->lock.store(0, std::memory_order_relaxed);
+      header->current.store(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count()), std::memory_order_relaxed);
+      tmp.reset();
+
+      boost::system::error_code ec;
+      boost::filesystem::create_hard_link(tmp_path, absolute_path, ec);
+      boost::filesystem::remove(tmp_path, ec);
+    }
+
+    boost::interprocess::file_mapping file(absolute_path.c_str(), boost::interprocess::read_write);
+    region = std::make_shared<boost::interprocess::mapped_region>(file, boost::interprocess::read_write);
+    const generation_header_t* header = static_cast<const generation_header_t*>(region->get_address());
+    if(region->get_size() < sizeof(generation_header_t)
+      || std::memcmp(header->magic, generation_magic, sizeof(generation_magic)) != 0)
+    {
+      CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": The file '" << absolute_path
+                << "' is not a valid generation file");
+      return nullptr;
+    }
+  }
+  catch(std::exception& e)
+  {
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << absolute_path << ": " << e.what());
+    return nullptr;
+  }
+
+  // the identity is read after the mapping, in case the file has been replaced meanwhile
+  if(fileId(absolute_path, dev, ino))
+  {
+    regions[root_directory] = GenerationMapping{region, dev, ino};
+  }
+  return region;
+}
+
+}  // namespace
+
+bool writerAlive(std::uint64_t lock)
+{
+  const pid_t pid = static_cast<pid_t>((lock & 0xffffffffu) >> 1);
+  return !(lock & 1) || pid == 0 || kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+std::uint64_t lockedWord()
+{
+  return (static_cast<std::uint64_t>(getpid()) << 1) | 1;
+}
+
+bool lockWriter(std::atomic<std::uint64_t>& lock, std::chrono::nanoseconds timeout, bool& recovered)
+{
+  // the liveness of the holder is checked every few yields, since it costs a system call
+  constexpr unsigned check_period = 256;
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  recovered = false;
+  std::uint64_t seq = lock.load(std::memory_order_relaxed);
+  for(unsigned spin = 1;; spin++)
+  {
+    const bool dead = (seq & 1) && spin % check_period == 0 && !writerAlive(seq);
+    if((!(seq & 1) || dead)
+      && lock.compare_exchange_weak(seq, (((seq >> 32) + 1) << 32) | lockedWord(), std::memory_order_acquire))
+    {
+      recovered = dead;
+      break;
+    }
+    if(seq & 1)
+    {
+      if(timeout.count() >= 0 && spin % check_period == 0 && std::chrono::steady_clock::now() > deadline)
+      {
+        return false;
+      }
+      std::this_thread::yield();
+      seq = lock.load(std::memory_order_relaxed);
+    }
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  if(recovered)
+  {
+    CNR_PARAM_LOG_WARN("The lock of a dead writer has been taken over");
+  }
+  return true;
+}
+
+void unlockWriter(std::atomic<std::uint64_t>& lock)
+{
+  lock.store(((lock.load(std::memory_order_relaxed) >> 32) + 1) << 32, std::memory_order_release);
+}
+
+std::uint64_t currentGeneration(const std::string& root_directory)
+{
+  std::shared_ptr<boost::interprocess::mapped_region> region = generationMapping(root_directory);
+  if(!region)
+  {
+    // without the generation file, every published payload is visible
+    return std::numeric_limits<std::uint64_t>::max() - 1;
+  }
+  return static_cast<generation_header_t*>(region->get_address())->current.load(std::memory_order_acquire);
+}
+
+GenerationLock::GenerationLock(const std::string& root_directory)
+  : region_(generationMapping(root_directory)), next_(0), locked_(false)
+{
+  if(region_)
+  {
+    generation_header_t* header = static_cast<generation_header_t*>(region_->get_address());
+    bool recovered = false;
+    lockWriter(header->lock, std::chrono::nanoseconds(-1), recovered);
+    locked_ = true;
+    next_ = header->current.load(std::memory_order_relaxed) + 1;
+  }
+}
+
+GenerationLock::~GenerationLock()
+{
+  if(locked_)
+  {
+    unlockWriter(static_cast<generation_header_t*>(region_->get_address())->lock);
+  }
+}
+
+void GenerationLock::publish()
+{
+  if(locked_)
+  {
+    generation_header_t* header = static_cast<generation_header_t*>(region_->get_address());
+    header->current.store(next_, std::memory_order_release);
+    unlockWriter(header->lock);
+    locked_ = false;
+  }
+}
+
+EntryWriter::EntryWriter(const std::string& absolute_path, payload_t type, std::size_t capacity, 
+                          std::uint64_t generation)
+  : absolute_path_(absolute_path), header_(nullptr), generation_(generation), target_(0), committed_(false)
+{
+  std::shared_ptr<boost::interprocess::mapped_region> region = lockedWriterMapping(absolute_path);
+  if(!region)
+  {
+    createTmp(type, capacity, nullptr);
+    return;
+  }
+
+  // The slot already staged with the same generation is rewritten, otherwise the older version is overwritten
+  entry_header_t* header = static_cast<entry_header_t*>(region->get_address());
+  target_ = header->slots[0].generation == generation ? 0
+          : header->slots[1].generation == generation ? 1
+          : header->slots[0].generation <= header->slots[1].generation ? 0 : 1;
+  if(header->capacity >= capacity)
+  {
+    // in-place rewrite
+    region_ = region;
+    header_ = header;
+    header_->writing = static_cast<std::uint32_t>(target_ + 1);
+    header_->slots[target_].type = static_cast<std::uint32_t>(type);
+    return;
+  }
+
+  replaced_region_ = region;  // it stays locked until the new file is in place
+  if(createTmp(type, std::max(capacity, 2 * header->capacity), header))
+  {
+    header_->slots[target_].type = static_cast<std::uint32_t>(type);
+  }
+  else
+  {
+    unlockEntry(header);
+    replaced_region_.reset();
+  }
+}
+
+bool EntryWriter::createTmp(payload_t type, std::size_t capacity, const entry_header_t* copy)
+{
+  capacity = std::max((capacity + 63) & ~std::size_t(63), std::size_t(64));
+  std::string tmp_path = tmpPath(absolute_path_);
+
+  std::shared_ptr<boost::interprocess::mapped_region> region(
+    createFileMapping(tmp_path, sizeof(entry_header_t) + 2 * capacity));
+  if(!region)
+  {
+    return false;
+  }
+  entry_header_t* header = static_cast<entry_header_t*>(region->get_address());
+  std::memcpy(header->magic, entry_magic, sizeof(entry_magic));
+  header->version  = entry_version;
+  header->flags    = 0;
+  header->capacity = capacity;
+  header->seq.store(lockedWord(), std::memory_order_relaxed);
+  header->writing = 0;
+  header->replaced.store(0, std::memory_order_relaxed);
+  header->slots[0] = entry_slot_t{0, 0, static_cast<std::uint32_t>(type), 0};
+  header->slots[1] = entry_slot_t{0, 0, static_cast<std::uint32_t>(type), 0};
+
+  if(copy)
+  {
+    // both the versions are kept, so that the slow readers do not lose the older one
+    header->flags = copy->flags;
+    for(std::size_t s = 0; s < 2; s++)
+    {
+      header->slots[s] = copy->slots[s];
+      header->slots[s].size = std::min(copy->slots[s].size, copy->capacity);
+      std::memcpy(reinterpret_cast<char*>(header) + sizeof(entry_header_t) + s * capacity,
+                  reinterpret_cast<const char*>(copy) + sizeof(entry_header_t) + s * copy->capacity,
+                  header->slots[s].size);
+    }
+  }
+
+  region_ = region;
+  header_ = header;
+  tmp_path_ = tmp_path;
+  return true;
+}
+
+const char* EntryWriter::latest(std::size_t& size) const
+{
+  std::size_t s = header_->slots[target_].generation == generation_ ? target_ : 1 - target_;
+  size = std::min(header_->slots[s].size, header_->capacity);
+  return slotData(s);
+}
+
+bool EntryWriter::reserve(std::size_t capacity)
+{
+  if(!header_ || committed_)
+  {
+    return false;
+  }
+  if(header_->capacity >= capacity)
+  {
+    return true;
+  }
+
+  std::shared_ptr<boost::interprocess::mapped_region> previous = region_;
+  entry_header_t* previous_header = header_;
+  std::string previous_tmp_path = tmp_path_;
+  if(previous_tmp_path.empty())
+  {
+    replaced_region_ = region_;  // it stays locked until the new file is in place
+  }
+  if(!createTmp(static_cast<payload_t>(previous_header->slots[target_].type), 
+                  std::max(capacity, 2 * previous_header->capacity), previous_header))
+  {
+    if(previous_tmp_path.empty())
+    {
+      replaced_region_.reset();
+    }
+    return false;
+  }
+
+  if(!previous_tmp_path.empty())
+  {
+    previous.reset();
+    boost::interprocess::file_mapping::remove(previous_tmp_path.c_str());
+  }
+  return true;
+}
+
+void EntryWriter::release()
+{
+  if(tmp_path_.empty())
+  {
+    unlockEntry(header_);
+  }
+  else
+  {
+    region_.reset();
+    boost::interprocess::file_mapping::remove(tmp_path_.c_str());
+    if(replaced_region_)
+    {
+      unlockEntry(static_cast<entry_header_t*>(replaced_region_->get_address()));
+    }
+  }
+  committed_ = true;
+}
+
+void EntryWriter::cancel()
+{
+  if(header_ && !committed_)
+  {
+    release();
+  }
+}
+
+EntryWriter::~EntryWriter()
+{
+  if(!header_ || committed_)
+  {
+    return;
+  }
+
+  // aborted write: the slot in place is no more consistent, while the new file is discarded
+  if(tmp_path_.empty())
+  {
+    header_->slots[target_].generation = 0;
+    header_->slots[target_].size = 0;
+  }
+  release();
+}
+
+void EntryWriter::commit(std::size_t size)
+{
+  header_->slots[target_].size = size;
+  header_->slots[target_].generation = generation_;
+  committed_ = true;
+  unlockEntry(header_);
+  if(tmp_path_.empty())
+  {
+    return;
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmp_path_, absolute_path_, ec);
+  if(ec)
+  {
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << absolute_path_
+      << ", rename failed: " << ec.message());
+    boost::interprocess::file_mapping::remove(tmp_path_.c_str());
+  }
+  if(replaced_region_)
+  {
+    entry_header_t* old_header = static_cast<entry_header_t*>(replaced_region_->get_address());
+    old_header->replaced.store(ec ? 0 : 1, std::memory_order_release);
+    unlockEntry(old_header);
+  }
+  if(!ec)
+  {
+    storeWriterMapping(absolute_path_, region_);
+  }
+}
+
+bool discardEntry(const std::string& absolute_path, std::uint64_t generation)
+{
+  std::shared_ptr<boost::interprocess::mapped_region> region = lockedWriterMapping(absolute_path);
+  if(!region)
+  {
+    return false;
+  }
+  entry_header_t* header = static_cast<entry_header_t*>(region->get_address());
+  for(auto& slot : header->slots)
+  {
+    if(slot.generation == generation)
+    {
+      slot.generation = 0;
+      slot.size = 0;
+    }
+  }
+  unlockEntry(header);
+  return true;
+}
+
+bool getEntryFlags(const std::string& absolute_path, std::uint32_t& flags)
+{
+  std::shared_ptr<boost::interprocess::mapped_region> region = writerMapping(absolute_path, false);
+  if(region && static_cast<entry_header_t*>(region->get_address())->replaced.load(std::memory_order_acquire))
+  {
+    region = writerMapping(absolute_path, true);
+  }
+  if(!region)
+  {
+    return false;
+  }
+  flags = static_cast<entry_header_t*>(region->get_address())->flags;
+  return true;
+}
+
+bool setEntryFlags(const std::string& absolute_path, std::uint32_t flags)
+{
+  std::shared_ptr<boost::interprocess::mapped_region> region = lockedWriterMapping(absolute_path);
+  if(!region)
+  {
+    return false;
+  }
+  entry_header_t* header = static_cast<entry_header_t*>(region->get_address());
+  header->flags |= flags;
+  unlockEntry(header);
+  return true;
+}
+
+bool EntryReader::open(const std::string& absolute_path, std::string& what)
+{
+  path_ = absolute_path;
+  try
+  {
+    boost::interprocess::file_mapping file(absolute_path.c_str(), boost::interprocess::read_only);
+    region_.reset(new boost::interprocess::mapped_region(file, boost::interprocess::read_only));
+  }
+  catch(boost::interprocess::interprocess_exception& e)
+  {
+    what = "Impossible to map the file '" + absolute_path + "': " + e.what();
+    return false;
+  }
+
+  const entry_header_t* header = static_cast<const entry_header_t*>(region_->get_address());
+  if(!validHeader(header, region_->get_size()))
+  {
+    what = "The file '" + absolute_path + "' is not a valid cnr_param entry";
+    return false;
+  }
+  header_ = header;
+  return true;
+}
+
+std::uint64_t EntryReader::begin() const
+{
+  // if the writer is dead, the lock is never released: the slot it was writing is skipped (see 'slot')
+  constexpr unsigned check_period = 256;
+  std::uint64_t seq = header_->seq.load(std::memory_order_acquire);
+  for(unsigned spin = 1; (seq & 1) && (spin % check_period != 0 || writerAlive(seq)); spin++)
+  {
+    std::this_thread::yield();
+    seq = header_->seq.load(std::memory_order_acquire);
+  }
+  return seq;
+}
+
+bool EntryReader::retry(std::uint64_t seq) const
+{
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return header_->seq.load(std::memory_order_relaxed) != seq;
+}
+
+int EntryReader::slot(std::uint64_t generation) const
+{
+  const std::uint32_t writing = (header_->seq.load(std::memory_order_acquire) & 1) ? header_->writing : 0;
+  const std::uint64_t g0 = header_->slots[0].generation;
+  const std::uint64_t g1 = header_->slots[1].generation;
+  const bool v0 = g0 && g0 <= generation && writing != 1;
+  const bool v1 = g1 && g1 <= generation && writing != 2;
+  return v0 && (!v1 || g0 > g1) ? 0 : v1 ? 1 : -1;
+}
+
+bool EntryReader::expired(std::uint64_t generation) const
+{
+  return header_->slots[0].generation > generation && header_->slots[1].generation > generation;
+}
+
+bool EntryReader::copy(std::uint64_t generation, entry_copy_t& out) const
+{
+  int s;
+  std::uint64_t seq;
+  do
+  {
+    seq = begin();
+    s = slot(generation);
+    if(s >= 0)
+    {
+      out.type = type(s);
+      out.generation = this->generation(s);
+      out.data.assign(data(s), size(s));
+    }
+    out.flags = flags();
+  } while(retry(seq));
+  return s >= 0;
+}
+
 }  // namespace utils
 }  // namespace param
 }  // namespace cnr 
@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <cnr_param/utils/logger.h>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+namespace log
+{
+
+namespace
+{
+
+std::atomic<int> threshold{-1};      // -1 until the environment is read
+std::atomic<bool> destroyed{false};  // the logger has been destroyed at exit, the messages are written directly
+
+void write(level_t level, const std::string& message)
+{
+  std::cerr << "[cnr_param][" << to_string(level) << "] " << message << std::endl;
+}
+
+/**
+ * @brief Bounded multi-producer single-consumer queue: each cell has a sequence number, that tells if the cell is free
+ * for the producer that claimed the position, or ready for the consumer. The producers claim the positions with a CAS,
+ * and they never wait for each other or for the consumer.
+ */
+struct cell_t
+{
+  std::atomic<std::uint64_t> seq;
+  level_t                    level;
+  std::uint32_t              length;
+  char                       text[max_message_length];
+};
+
+struct Logger
+{
+  cell_t cells[queue_capacity];
+  alignas(64) std::atomic<std::uint64_t> enqueue_pos{0};
+  alignas(64) std::uint64_t dequeue_pos = 0;  // owned by the drain thread
+  std::atomic<std::uint64_t> written{0};
+  std::atomic<std::uint64_t> dropped{0};
+  std::atomic<bool> started{false};
+
+  std::mutex mutex;  // start and stop of the thread, sink, and conditions
+  std::condition_variable pending;
+  std::condition_variable drained;
+  std::thread* thread = nullptr;
+  pid_t owner = 0;
+  bool stop = false;
+  sink_t sink;
+
+  Logger();
+  ~Logger();
+
+  void reset()
+  {
+    for(std::size_t i = 0; i < queue_capacity; i++)
+    {
+      cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+    enqueue_pos.store(0, std::memory_order_relaxed);
+    dequeue_pos = 0;
+    written.store(0, std::memory_order_relaxed);
+  }
+
+  bool enqueue(level_t level, const std::string& message)
+  {
+    std::uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    cell_t* cell = nullptr;
+    for(;;)
+    {
+      cell = &cells[pos % queue_capacity];
+      const std::uint64_t seq = cell->seq.load(std::memory_order_acquire);
+      const std::int64_t diff = static_cast<std::int64_t>(seq) - static_cast<std::int64_t>(pos);
+      if(diff == 0)
+      {
+        if(enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if(diff < 0)
+      {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      else
+      {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    cell->level = level;
+    cell->length = static_cast<std::uint32_t>(std::min(message.size(), max_message_length));
+    std::memcpy(cell->text, message.data(), cell->length);
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool dequeue(level_t& level, std::string& message)
+  {
+    cell_t& cell = cells[dequeue_pos % queue_capacity];
+    if(cell.seq.load(std::memory_order_acquire) != dequeue_pos + 1)
+    {
+      return false;
+    }
+    level = cell.level;
+    message.assign(cell.text, cell.length);
+    if(cell.length == max_message_length)
+    {
+      message += " [...]";
+    }
+    cell.seq.store(dequeue_pos + queue_capacity, std::memory_order_release);
+    dequeue_pos++;
+    return true;
+  }
+
+  void drain()
+  {
+    level_t level;
+    std::string message;
+    std::unique_lock<std::mutex> lock(mutex);
+    for(;;)
+    {
+      while(dequeue(level, message))
+      {
+        if(sink)
+        {
+          sink(level, message);
+        }
+        else
+        {
+          write(level, message);
+        }
+        written.fetch_add(1, std::memory_order_release);
+      }
+      drained.notify_all();
+      if(stop)
+      {
+        break;
+      }
+      // the producers notify without the lock, so a wake up may be lost: the timeout bounds the delay
+      pending.wait_for(lock, std::chrono::milliseconds(20));
+    }
+  }
+
+  void start()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!started.load(std::memory_order_relaxed))
+    {
+      owner = getpid();
+      thread = new std::thread([this]() { drain(); });
+      started.store(true, std::memory_order_release);
+    }
+  }
+};
+
+Logger& logger()
+{
+  static Logger l;
+  return l;
+}
+
+Logger::Logger()
+{
+  reset();
+  pthread_atfork([]() { logger().mutex.lock(); },
+                 []() { logger().mutex.unlock(); },
+                 []() {
+                   // the drain thread does not exist in the child: the messages of the parent are discarded, and the
+                   // thread is started again at the first message of the child
+                   Logger& l = logger();
+                   l.thread = nullptr;
+                   l.started.store(false, std::memory_order_relaxed);
+                   l.stop = false;
+                   l.reset();
+                   l.mutex.unlock();
+                 });
+}
+
+Logger::~Logger()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  pending.notify_one();
+  if(thread && owner == getpid())
+  {
+    thread->join();
+    delete thread;
+  }
+  thread = nullptr;
+  destroyed.store(true, std::memory_order_release);
+}
+
+level_t parse(const char* value)
+{
+  const std::string v = value ? value : "";
+  for(int l = CNR_PARAM_LOG_LEVEL_TRACE; l <= CNR_PARAM_LOG_LEVEL_OFF; l++)
+  {
+    if(v == to_string(static_cast<level_t>(l)))
+    {
+      return static_cast<level_t>(l);
+    }
+  }
+  return level_t::warn;
+}
+
+}  // namespace
+
+const char* to_string(level_t level)
+{
+  switch(level)
+  {
+    case level_t::trace: return "trace";
+    case level_t::debug: return "debug";
+    case level_t::info:  return "info";
+    case level_t::warn:  return "warn";
+    case level_t::error: return "error";
+    case level_t::off:   return "off";
+  }
+  return "unknown";
+}
+
+level_t level()
+{
+  int t = threshold.load(std::memory_order_relaxed);
+  if(t < 0)
+  {
+    t = static_cast<int>(parse(std::getenv("CNR_PARAM_LOG_LEVEL")));
+    threshold.store(t, std::memory_order_relaxed);
+  }
+  return static_cast<level_t>(t);
+}
+
+void setLevel(level_t level)
+{
+  threshold.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+bool push(level_t level, const std::string& message)
+{
+  if(destroyed.load(std::memory_order_acquire))
+  {
+    write(level, message);
+    return true;
+  }
+  Logger& l = logger();
+  if(!l.started.load(std::memory_order_acquire))
+  {
+    l.start();
+  }
+  const bool ok = l.enqueue(level, message);
+  l.pending.notify_one();
+  return ok;
+}
+
+void flush()
+{
+  if(destroyed.load(std::memory_order_acquire))
+  {
+    return;
+  }
+  Logger& l = logger();
+  if(!l.started.load(std::memory_order_acquire) || std::this_thread::get_id() == l.thread->get_id())
+  {
+    return;
+  }
+  const std::uint64_t target = l.enqueue_pos.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(l.mutex);
+  l.pending.notify_one();
+  l.drained.wait(lock, [&l, target]() { return l.written.load(std::memory_order_acquire) >= target; });
+}
+
+std::uint64_t dropped()
+{
+  return destroyed.load(std::memory_order_acquire) ? 0 : logger().dropped.load(std::memory_order_relaxed);
+}
+
+void setSink(sink_t sink)
+{
+  if(destroyed.load(std::memory_order_acquire))
+  {
+    return;
+  }
+  Logger& l = logger();
+  std::lock_guard<std::mutex> lock(l.mutex);
+  l.sink = std::move(sink);
+}
+
+}  // namespace log
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
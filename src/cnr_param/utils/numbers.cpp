@@ -0,0 +1,873 @@
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define CNR_PARAM_NUMBERS_X86 1
+#endif
+
+#include <cnr_param/utils/numbers.h>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+
+namespace
+{
+
+// =============================================================================================
+// PARSER SELECTION
+// =============================================================================================
+bool supported(number_parser_t parser)
+{
+  switch(parser)
+  {
+    case number_parser_t::yaml:
+    case number_parser_t::portable:
+      return true;
+#if defined(CNR_PARAM_NUMBERS_X86)
+    case number_parser_t::sse:
+      return __builtin_cpu_supports("sse2");
+    case number_parser_t::avx2:
+      return __builtin_cpu_supports("avx2");
+#endif
+    default:
+      return false;
+  }
+}
+
+number_parser_t default_parser()
+{
+  const char* env_p = std::getenv("CNR_PARAM_NUMBER_PARSER");
+  if(env_p)
+  {
+    for(number_parser_t p : {number_parser_t::yaml, number_parser_t::portable, number_parser_t::sse,
+                             number_parser_t::avx2})
+    {
+      if(std::strcmp(env_p, to_string(p)) == 0 && supported(p))
+      {
+        return p;
+      }
+    }
+  }
+  return supported(number_parser_t::avx2) ? number_parser_t::avx2
+       : supported(number_parser_t::sse)  ? number_parser_t::sse
+       :                                     number_parser_t::portable;
+}
+
+std::atomic<int>& parser_in_use()
+{
+  static std::atomic<int> parser{static_cast<int>(default_parser())};
+  return parser;
+}
+
+// =============================================================================================
+// STAGE 1: CLASSIFICATION OF THE BYTES, 64 AT A TIME
+// =============================================================================================
+constexpr std::size_t block_size = 64;
+
+/**
+ * @brief The masks of a block of 64 bytes: the bit i refers to the byte i of the block
+ */
+struct block_t
+{
+  std::uint64_t num;     // digits, '+', '-', '.', 'e', 'E'
+  std::uint64_t events;  // '[', ']', ',', '\n', and the first byte of each number
+};
+
+enum byte_class_t : std::uint8_t
+{
+  cls_other = 0,
+  cls_num = 1,
+  cls_space = 2,
+  cls_structural = 4  // '[', ']', ',', '\n'
+};
+
+struct class_table_t
+{
+  std::uint8_t cls[256];
+
+  constexpr class_table_t() : cls()
+  {
+    for(int c = '0'; c <= '9'; c++)
+    {
+      cls[c] = cls_num;
+    }
+    for(char c : {'+', '-', '.', 'e', 'E'})
+    {
+      cls[static_cast<unsigned char>(c)] = cls_num;
+    }
+    for(char c : {' ', '\t', '\r'})
+    {
+      cls[static_cast<unsigned char>(c)] = cls_space;
+    }
+    for(char c : {'[', ']', ',', '\n'})
+    {
+      cls[static_cast<unsigned char>(c)] = cls_structural;
+    }
+  }
+};
+
+constexpr class_table_t class_table;
+
+/**
+ * @brief Classify 64 bytes
+ *
+ * @return false if any byte cannot be part of a sequence of plain numbers (letters, quotes, '#', '&', ...)
+ */
+using classify_fn = bool (*)(const char* p, std::uint64_t& num, std::uint64_t& structural);
+
+bool classify_portable(const char* p, std::uint64_t& num, std::uint64_t& structural)
+{
+  std::uint64_t n = 0;
+  std::uint64_t s = 0;
+  bool ok = true;
+  for(std::size_t i = 0; i < block_size; i++)
+  {
+    const std::uint8_t c = class_table.cls[static_cast<unsigned char>(p[i])];
+    ok &= c != cls_other;
+    n |= std::uint64_t(c == cls_num) << i;
+    s |= std::uint64_t(c == cls_structural) << i;
+  }
+  num = n;
+  structural = s;
+  return ok;
+}
+
+#if defined(CNR_PARAM_NUMBERS_X86)
+__attribute__((target("sse2"))) inline __m128i eq(__m128i x, char c)
+{
+  return _mm_cmpeq_epi8(x, _mm_set1_epi8(c));
+}
+
+__attribute__((target("avx2"))) inline __m256i eq(__m256i x, char c)
+{
+  return _mm256_cmpeq_epi8(x, _mm256_set1_epi8(c));
+}
+
+__attribute__((target("sse2"))) bool classify_sse(const char* p, std::uint64_t& num, std::uint64_t& structural)
+{
+  std::uint64_t n = 0;
+  std::uint64_t s = 0;
+  std::uint64_t known = 0;
+  for(std::size_t k = 0; k < block_size; k += 16)
+  {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + k));
+
+    const __m128i d = _mm_sub_epi8(x, _mm_set1_epi8('0'));
+    const __m128i digit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+    const __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));  // 'E' -> 'e'
+    const __m128i sign = _mm_or_si128(_mm_or_si128(eq(x, '+'), eq(x, '-')), eq(x, '.'));
+    const __m128i nv = _mm_or_si128(_mm_or_si128(digit, sign), _mm_cmpeq_epi8(lower, _mm_set1_epi8('e')));
+    const __m128i sv = _mm_or_si128(_mm_or_si128(eq(x, '['), eq(x, ']')), _mm_or_si128(eq(x, ','), eq(x, '\n')));
+    const __m128i wv = _mm_or_si128(_mm_or_si128(eq(x, ' '), eq(x, '\t')), eq(x, '\r'));
+
+    const std::uint64_t nm = static_cast<std::uint16_t>(_mm_movemask_epi8(nv));
+    const std::uint64_t sm = static_cast<std::uint16_t>(_mm_movemask_epi8(sv));
+    const std::uint64_t wm = static_cast<std::uint16_t>(_mm_movemask_epi8(wv));
+    n |= nm << k;
+    s |= sm << k;
+    known |= (nm | sm | wm) << k;
+  }
+  num = n;
+  structural = s;
+  return known == ~std::uint64_t(0);
+}
+
+__attribute__((target("avx2"))) bool classify_avx2(const char* p, std::uint64_t& num, std::uint64_t& structural)
+{
+  std::uint64_t n = 0;
+  std::uint64_t s = 0;
+  std::uint64_t known = 0;
+  for(std::size_t k = 0; k < block_size; k += 32)
+  {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + k));
+
+    const __m256i d = _mm256_sub_epi8(x, _mm256_set1_epi8('0'));
+    const __m256i digit = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+    const __m256i lower = _mm256_or_si256(x, _mm256_set1_epi8(0x20));  // 'E' -> 'e'
+    const __m256i sign = _mm256_or_si256(_mm256_or_si256(eq(x, '+'), eq(x, '-')), eq(x, '.'));
+    const __m256i nv =
+        _mm256_or_si256(_mm256_or_si256(digit, sign), _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('e')));
+    const __m256i sv =
+        _mm256_or_si256(_mm256_or_si256(eq(x, '['), eq(x, ']')), _mm256_or_si256(eq(x, ','), eq(x, '\n')));
+    const __m256i wv = _mm256_or_si256(_mm256_or_si256(eq(x, ' '), eq(x, '\t')), eq(x, '\r'));
+
+    const std::uint64_t nm = static_cast<std::uint32_t>(_mm256_movemask_epi8(nv));
+    const std::uint64_t sm = static_cast<std::uint32_t>(_mm256_movemask_epi8(sv));
+    const std::uint64_t wm = static_cast<std::uint32_t>(_mm256_movemask_epi8(wv));
+    n |= nm << k;
+    s |= sm << k;
+    known |= (nm | sm | wm) << k;
+  }
+  num = n;
+  structural = s;
+  return known == ~std::uint64_t(0);
+}
+#endif
+
+classify_fn classifier(number_parser_t parser)
+{
+  switch(parser)
+  {
+#if defined(CNR_PARAM_NUMBERS_X86)
+    case number_parser_t::avx2:
+      return &classify_avx2;
+    case number_parser_t::sse:
+      return &classify_sse;
+#endif
+    case number_parser_t::portable:
+      return &classify_portable;
+    default:
+      return nullptr;
+  }
+}
+
+/**
+ * @brief Classify the whole text. The last block is padded with spaces.
+ *
+ * @return the number of numbers, or -1 if the text has a byte of other class
+ */
+long scan(const char* text, std::size_t size, classify_fn classify, std::vector<block_t>& blocks)
+{
+  blocks.resize((size + block_size - 1) / block_size);
+  long count = 0;
+  std::uint64_t carry = 0;  // 1 if the previous block ends within a number
+  for(std::size_t b = 0; b < blocks.size(); b++)
+  {
+    const char* p = text + b * block_size;
+    char tail[block_size];
+    if(size - b * block_size < block_size)
+    {
+      std::memset(tail, ' ', block_size);
+      std::memcpy(tail, p, size - b * block_size);
+      p = tail;
+    }
+
+    std::uint64_t num;
+    std::uint64_t structural;
+    if(!classify(p, num, structural))
+    {
+      return -1;
+    }
+    const std::uint64_t starts = num & ~((num << 1) | carry);
+    carry = num >> 63;
+    blocks[b] = block_t{num, structural | starts};
+    count += __builtin_popcountll(starts);
+  }
+  return count;
+}
+
+// =============================================================================================
+// CONVERSION OF THE NUMBERS
+// =============================================================================================
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+inline bool is_eight_digits(std::uint64_t v)
+{
+  return !(((v + 0x4646464646464646ull) | (v - 0x3030303030303030ull)) & 0x8080808080808080ull);
+}
+
+// the eight digits are reduced in pairs, quads and octets by three multiplications
+inline std::uint32_t eight_digits(std::uint64_t v)
+{
+  const std::uint64_t mask = 0x000000FF000000FFull;
+  const std::uint64_t mul1 = 0x000F424000000064ull;  // 100 + (1000000 << 32)
+  const std::uint64_t mul2 = 0x0000271000000001ull;  // 1 + (10000 << 32)
+  v -= 0x3030303030303030ull;
+  v = (v * 10) + (v >> 8);
+  v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+  return static_cast<std::uint32_t>(v);
+}
+#endif
+
+constexpr int max_mantissa_digits = 19;  // 10^19 - 1 < 2^64
+
+/**
+ * @brief Accumulate the digits from p in m. After 19 digits m is no more exact, and only 'count' is incremented.
+ */
+inline const char* digits(const char* p, const char* end, std::uint64_t& m, int& count)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while(end - p >= 8 && count + 8 <= max_mantissa_digits)
+  {
+    std::uint64_t v;
+    std::memcpy(&v, p, 8);
+    if(!is_eight_digits(v))
+    {
+      break;
+    }
+    m = m * 100000000ull + eight_digits(v);
+    count += 8;
+    p += 8;
+  }
+#endif
+  while(p < end && static_cast<unsigned char>(*p - '0') < 10)
+  {
+    if(count < max_mantissa_digits)
+    {
+      m = m * 10 + static_cast<unsigned char>(*p - '0');
+    }
+    count++;
+    p++;
+  }
+  return p;
+}
+
+template<typename T>
+bool parse_integer(const char* p, const char* end, T& value)
+{
+  bool negative = false;
+  if(p < end && (*p == '+' || *p == '-'))
+  {
+    negative = *p == '-';
+    p++;
+  }
+  // yaml-cpp reads '0x..' as hexadecimal and '0..' as octal
+  if(p == end || (*p == '0' && end - p > 1))
+  {
+    return false;
+  }
+
+  std::uint64_t m = 0;
+  int count = 0;
+  if(digits(p, end, m, count) != end || count == 0 || count > max_mantissa_digits)
+  {
+    return false;
+  }
+
+  using U = typename std::make_unsigned<T>::type;
+  if constexpr(std::is_unsigned<T>::value)
+  {
+    if(negative || m > std::numeric_limits<T>::max())
+    {
+      return false;
+    }
+    value = static_cast<T>(m);
+  }
+  else
+  {
+    const std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+    if(m > limit)
+    {
+      return false;
+    }
+    value = static_cast<T>(negative ? static_cast<U>(0 - m) : static_cast<U>(m));
+  }
+  return true;
+}
+
+/**
+ * @brief The exact powers of 10 in T. The product (or the quotient) of two exact values is correctly rounded.
+ */
+template<typename T>
+struct exact_t;
+
+template<>
+struct exact_t<double>
+{
+  static constexpr int digits = 15;
+  static constexpr int exponent = 22;
+  static constexpr double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+};
+
+template<>
+struct exact_t<float>
+{
+  static constexpr int digits = 7;
+  static constexpr int exponent = 10;
+  static constexpr float pow10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+};
+
+template<typename T>
+bool parse_floating(const char* begin, const char* end, T& value)
+{
+  const char* p = begin;
+  bool negative = false;
+  if(p < end && (*p == '+' || *p == '-'))
+  {
+    negative = *p == '-';
+    p++;
+  }
+  const char* unsigned_begin = p;
+
+  std::uint64_t m = 0;
+  int count = 0;
+  p = digits(p, end, m, count);
+  int fraction = 0;
+  if(p < end && *p == '.')
+  {
+    const char* f = ++p;
+    p = digits(p, end, m, count);
+    fraction = static_cast<int>(p - f);
+  }
+  if(count == 0)
+  {
+    return false;
+  }
+
+  long exponent = 0;
+  bool exact = true;
+  if(p < end && (*p == 'e' || *p == 'E'))
+  {
+    p++;
+    bool negative_exponent = false;
+    if(p < end && (*p == '+' || *p == '-'))
+    {
+      negative_exponent = *p == '-';
+      p++;
+    }
+    const char* e = p;
+    for(; p < end && static_cast<unsigned char>(*p - '0') < 10; p++)
+    {
+      if(exponent < 100000)
+      {
+        exponent = exponent * 10 + (*p - '0');
+      }
+      else
+      {
+        exact = false;
+      }
+    }
+    if(p == e)
+    {
+      return false;
+    }
+    exponent = negative_exponent ? -exponent : exponent;
+  }
+  if(p != end)
+  {
+    return false;
+  }
+  exponent -= fraction;
+
+  // Clinger's fast path: both the mantissa and the power of 10 are exact in T
+  if(exact && count <= exact_t<T>::digits && exponent >= -exact_t<T>::exponent && exponent <= exact_t<T>::exponent)
+  {
+    T v = static_cast<T>(m);
+    v = exponent < 0 ? v / exact_t<T>::pow10[-exponent] : v * exact_t<T>::pow10[exponent];
+    value = negative ? -v : v;
+    return true;
+  }
+
+  // the long mantissas and the large exponents are correctly rounded by the standard library
+  T v;
+  const auto res = std::from_chars(unsigned_begin, end, v);
+  if(res.ec != std::errc() || res.ptr != end)
+  {
+    return false;
+  }
+  value = negative ? -v : v;
+  return true;
+}
+
+template<typename T>
+inline bool convert(const char* begin, const char* end, T& value)
+{
+  if constexpr(std::is_floating_point<T>::value)
+  {
+    return parse_floating(begin, end, value);
+  }
+  else
+  {
+    return parse_integer(begin, end, value);
+  }
+}
+
+// =============================================================================================
+// STAGE 2: STRUCTURE OF THE SEQUENCE
+// =============================================================================================
+/**
+ * @brief The state machine over the events of the blocks: the structural bytes, and the first byte of each number.
+ * The whitespaces are skipped by the masks, and they are never visited.
+ */
+template<typename T>
+class sequence_parser_t
+{
+public:
+  sequence_parser_t(const char* text, std::size_t size, const std::vector<block_t>& blocks, std::vector<T>& values)
+    : text_(text), size_(size), blocks_(blocks), values_(values)
+  {
+  }
+
+  bool run(number_shape_t& shape)
+  {
+    for(std::size_t b = 0; b < blocks_.size(); b++)
+    {
+      std::uint64_t events = blocks_[b].events;
+      while(events)
+      {
+        const std::size_t i = b * block_size + static_cast<std::size_t>(__builtin_ctzll(events));
+        events &= events - 1;
+        if(!event(i))
+        {
+          return false;
+        }
+      }
+    }
+    return finish(shape);
+  }
+
+private:
+  enum class mode_t
+  {
+    none,
+    flow,   // [1, 2, 3]
+    block   // - 1\n- 2\n
+  };
+
+  enum class item_t
+  {
+    indicator,  // the next token is '- '
+    value,      // the value of the item, after '- '
+    end         // the value has been read, the next event is the end of the line
+  };
+
+  int level() const { return depth_ + (mode_ == mode_t::block ? 1 : 0); }
+
+  bool event(std::size_t i)
+  {
+    switch(text_[i])
+    {
+      case '[': return open();
+      case ']': return close();
+      case ',': return comma();
+      case '\n': return newline(i);
+      default: return token(i);
+    }
+  }
+
+  bool open()
+  {
+    if(depth_ == 0)
+    {
+      if(mode_ == mode_t::none)
+      {
+        mode_ = mode_t::flow;
+      }
+      else if(mode_ != mode_t::block || item_ != item_t::value)
+      {
+        return false;
+      }
+    }
+    else if(!expect_value_)
+    {
+      return false;
+    }
+
+    depth_++;
+    if(level() > 2 || (level() == 2 && nested_ == 1))
+    {
+      return false;
+    }
+    if(level() == 2)
+    {
+      nested_ = 2;
+      row_ = 0;
+    }
+    expect_value_ = true;
+    opened_ = true;
+    return true;
+  }
+
+  bool close()
+  {
+    if(depth_ == 0 || (expect_value_ && !opened_))  // unbalanced, or trailing comma
+    {
+      return false;
+    }
+    if(level() == 2)
+    {
+      if(rows_ == 0)
+      {
+        cols_ = row_;
+      }
+      else if(row_ != cols_)
+      {
+        return false;
+      }
+      rows_++;
+    }
+    depth_--;
+    expect_value_ = false;
+    opened_ = false;
+    if(depth_ == 0)
+    {
+      done_ = mode_ == mode_t::flow;
+      item_ = item_t::end;
+    }
+    return true;
+  }
+
+  bool comma()
+  {
+    if(depth_ == 0 || expect_value_)
+    {
+      return false;
+    }
+    expect_value_ = true;
+    opened_ = false;
+    return true;
+  }
+
+  bool newline(std::size_t i)
+  {
+    line_ = i + 1;
+    if(depth_ == 0 && mode_ == mode_t::block)
+    {
+      if(item_ == item_t::value)  // null item
+      {
+        return false;
+      }
+      item_ = item_t::indicator;
+    }
+    return true;
+  }
+
+  bool token(std::size_t i)
+  {
+    const std::size_t end = token_end(i);
+    if(depth_ == 0)
+    {
+      const bool indicator = end == i + 1 && text_[i] == '-' && end < size_ && text_[end] == ' ';
+      if(done_)
+      {
+        return false;
+      }
+      if(indicator && (mode_ == mode_t::none || (mode_ == mode_t::block && item_ == item_t::indicator
+                                                  && i - line_ == column_)))
+      {
+        mode_ = mode_t::block;
+        column_ = i - line_;
+        item_ = item_t::value;
+        return true;
+      }
+      if(indicator || mode_ != mode_t::block || item_ != item_t::value || nested_ == 2)
+      {
+        return false;
+      }
+      nested_ = 1;
+      item_ = item_t::end;
+      return push(i, end);
+    }
+
+    if(!expect_value_)
+    {
+      return false;
+    }
+    expect_value_ = false;
+    opened_ = false;
+    if(level() == 1)
+    {
+      if(nested_ == 2)
+      {
+        return false;
+      }
+      nested_ = 1;
+    }
+    else
+    {
+      row_++;
+    }
+    return push(i, end);
+  }
+
+  bool finish(number_shape_t& shape) const
+  {
+    if(mode_ == mode_t::none || depth_ != 0 || (mode_ == mode_t::block && item_ == item_t::value))
+    {
+      return false;
+    }
+    shape.nested = nested_ == 2;
+    shape.rows = shape.nested ? rows_ : 1;
+    shape.cols = shape.nested ? cols_ : values_.size();
+    return true;
+  }
+
+  /**
+   * @brief The first byte after the number that starts at i
+   */
+  std::size_t token_end(std::size_t i) const
+  {
+    std::size_t b = i / block_size;
+    std::uint64_t other = ~blocks_[b].num >> (i % block_size);
+    if(other)
+    {
+      return i + static_cast<std::size_t>(__builtin_ctzll(other));
+    }
+    for(b++; b < blocks_.size(); b++)
+    {
+      if(~blocks_[b].num)
+      {
+        return b * block_size + static_cast<std::size_t>(__builtin_ctzll(~blocks_[b].num));
+      }
+    }
+    return size_;
+  }
+
+  bool push(std::size_t i, std::size_t end)
+  {
+    T v;
+    if(!convert(text_ + i, text_ + end, v))
+    {
+      return false;
+    }
+    values_.push_back(v);
+    return true;
+  }
+
+  const char* text_;
+  std::size_t size_;
+  const std::vector<block_t>& blocks_;
+  std::vector<T>& values_;
+
+  mode_t mode_ = mode_t::none;
+  item_t item_ = item_t::indicator;
+  int depth_ = 0;              // open brackets
+  int nested_ = 0;             // 0: no values yet, 1: sequence of numbers, 2: sequence of rows
+  bool expect_value_ = false;  // after '[' or ','
+  bool opened_ = false;        // just after '['
+  bool done_ = false;          // the flow sequence has been closed
+  std::size_t line_ = 0;       // the first byte of the current line
+  std::size_t column_ = 0;     // the column of the block indicators
+  std::size_t row_ = 0;
+  std::size_t rows_ = 0;
+  std::size_t cols_ = 0;
+};
+
+}  // namespace
+
+const char* to_string(number_parser_t parser)
+{
+  switch(parser)
+  {
+    case number_parser_t::yaml: return "yaml";
+    case number_parser_t::portable: return "portable";
+    case number_parser_t::sse: return "sse";
+    case number_parser_t::avx2: return "avx2";
+  }
+  return "unknown";
+}
+
+number_parser_t numberParser()
+{
+  return static_cast<number_parser_t>(parser_in_use().load(std::memory_order_relaxed));
+}
+
+bool setNumberParser(number_parser_t parser)
+{
+  if(!supported(parser))
+  {
+    return false;
+  }
+  parser_in_use().store(static_cast<int>(parser), std::memory_order_relaxed);
+  return true;
+}
+
+template<typename T>
+bool parse_number(const char* begin, const char* end, T& value)
+{
+  static_assert(is_bulk_number<T>::value, "parse_number: unsupported type");
+  return numberParser() != number_parser_t::yaml && convert(begin, end, value);
+}
+
+template<typename T>
+bool parse_numbers(const char* begin, const char* end, std::vector<T>& values, number_shape_t& shape)
+{
+  static_assert(is_bulk_number<T>::value, "parse_numbers: unsupported type");
+  const classify_fn classify = classifier(numberParser());
+  if(!classify || end <= begin)
+  {
+    return false;
+  }
+
+  thread_local std::vector<block_t> blocks;
+  const std::size_t size = static_cast<std::size_t>(end - begin);
+  const long count = scan(begin, size, classify, blocks);
+  if(count < 0)
+  {
+    return false;
+  }
+  values.clear();
+  values.reserve(static_cast<std::size_t>(count));
+  return sequence_parser_t<T>(begin, size, blocks, values).run(shape);
+}
+
+bool payload_value(const std::string& payload, const std::string& key, const char*& begin, const char*& end)
+{
+  const char* p = payload.data();
+  const char* last = payload.data() + payload.size();
+
+  // '"key":' as written by 'set', or 'key:' as written by the server
+  if(p < last && *p == '"')
+  {
+    p++;
+    if(static_cast<std::size_t>(last - p) < key.size() + 2 || std::memcmp(p, key.data(), key.size()) != 0
+      || p[key.size()] != '"' || p[key.size() + 1] != ':')
+    {
+      return false;
+    }
+    p += key.size() + 2;
+  }
+  else
+  {
+    if(static_cast<std::size_t>(last - p) < key.size() + 1 || std::memcmp(p, key.data(), key.size()) != 0
+      || p[key.size()] != ':')
+    {
+      return false;
+    }
+    p += key.size() + 1;
+  }
+
+  // the value starts on the line of the key with '[', or on the next line
+  while(p < last && (*p == ' ' || *p == '\t'))
+  {
+    p++;
+  }
+  if(p < last && *p == '\r')
+  {
+    p++;
+  }
+  if(p == last || (*p != '[' && *p != '\n'))
+  {
+    return false;
+  }
+  begin = *p == '\n' ? p + 1 : p;
+  end = last;
+  while(end > begin && end[-1] == '\0')  // padding of the mapped file
+  {
+    end--;
+  }
+  return true;
+}
+
+#define CNR_PARAM_INSTANTIATE_NUMBERS(T)                                                              \
+  template bool parse_number<T>(const char* begin, const char* end, T& value);                        \
+  template bool parse_numbers<T>(const char* begin, const char* end, std::vector<T>& values,          \
+                                 number_shape_t& shape);
+
+CNR_PARAM_INSTANTIATE_NUMBERS(short)
+CNR_PARAM_INSTANTIATE_NUMBERS(unsigned short)
+CNR_PARAM_INSTANTIATE_NUMBERS(int)
+CNR_PARAM_INSTANTIATE_NUMBERS(unsigned int)
+CNR_PARAM_INSTANTIATE_NUMBERS(long)
+CNR_PARAM_INSTANTIATE_NUMBERS(unsigned long)
+CNR_PARAM_INSTANTIATE_NUMBERS(long long)
+CNR_PARAM_INSTANTIATE_NUMBERS(unsigned long long)
+CNR_PARAM_INSTANTIATE_NUMBERS(float)
+CNR_PARAM_INSTANTIATE_NUMBERS(double)
+
+#undef CNR_PARAM_INSTANTIATE_NUMBERS
+
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
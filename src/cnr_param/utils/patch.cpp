@@ -0,0 +1,162 @@
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include <yaml-cpp/yaml.h>
+
+#include <cnr_param/utils/interprocess.h>
+#include <cnr_param/utils/patch.h>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+
+namespace
+{
+
+bool createNamespace(const std::string& absolute_path, const std::string& name, std::uint64_t generation, 
+                      std::string& what)
+{
+  YAML::Node node;
+  node[name] = YAML::Node(YAML::NodeType::Map);
+  std::string str = YAML::Dump(node) + "\n";
+
+  EntryWriter entry(absolute_path, payload_t::yaml, str.size(), generation);
+  if(!entry)
+  {
+    what = "Impossible to create the file mapping '" + absolute_path + "'";
+    return false;
+  }
+  std::memcpy(entry.data(), str.c_str(), str.size());
+  entry.commit(str.size());
+  return true;
+}
+
+bool listed(const char* data, std::size_t size, const std::string& relative_key)
+{
+  std::size_t begin = 0;
+  while(begin < size)
+  {
+    const char* eol = static_cast<const char*>(std::memchr(data + begin, '\n', size - begin));
+    std::size_t end = eol ? static_cast<std::size_t>(eol - data) : size;
+    if(end - begin == relative_key.size() && std::memcmp(data + begin, relative_key.data(), end - begin) == 0)
+    {
+      return true;
+    }
+    begin = end + 1;
+  }
+  return false;
+}
+
+}  // namespace
+
+std::string patchesPath(const std::string& absolute_path)
+{
+  return boost::filesystem::path(absolute_path).replace_extension(".patches").string();
+}
+
+bool patchAncestors(const boost::filesystem::path& root, const std::vector<std::string>& keys, 
+                      std::uint64_t generation, std::vector<std::string>& written, std::string& what)
+{
+  boost::filesystem::path ancestor = root;
+  for(std::size_t k = 1; k < keys.size(); k++)
+  {
+    ancestor /= keys.at(k - 1);
+    const std::string absolute_path = ancestor.string() + ".yaml";
+
+    std::string relative_key = keys.at(k);
+    for(std::size_t i = k + 1; i < keys.size(); i++)
+    {
+      relative_key += "/" + keys.at(i);
+    }
+
+    std::uint32_t flags = 0;
+    if(!getEntryFlags(absolute_path, flags))
+    {
+      if(!createNamespace(absolute_path, keys.at(k - 1), generation, what))
+      {
+        return false;
+      }
+      written.push_back(absolute_path);
+    }
+
+    // The list only grows: the readers graft a descendant only if it is newer than the namespace
+    const std::string patches_path = patchesPath(absolute_path);
+    EntryWriter list(patches_path, payload_t::patches, 0, generation);
+    if(!list)
+    {
+      what = "Impossible to create the file mapping '" + patches_path + "'";
+      return false;
+    }
+
+    std::size_t size = 0;
+    const char* latest = list.latest(size);
+    if(listed(latest, size, relative_key))
+    {
+      list.cancel();
+    }
+    else
+    {
+      if(!list.reserve(size + relative_key.size() + 1))
+      {
+        what = "Impossible to grow the file mapping '" + patches_path + "'";
+        return false;
+      }
+      latest = list.latest(size);
+      if(latest != list.data())
+      {
+        std::memcpy(list.data(), latest, size);
+      }
+      std::memcpy(list.data() + size, relative_key.data(), relative_key.size());
+      size += relative_key.size();
+      list.data()[size++] = '\n';
+      list.commit(size);
+      written.push_back(patches_path);
+    }
+
+    if(!(flags & entry_flags::patched) && !setEntryFlags(absolute_path, entry_flags::patched))
+    {
+      what = "Impossible to patch the entry '" + absolute_path + "'";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool readPatches(const std::string& absolute_path, std::vector<std::string>& relative_keys, std::string& what)
+{
+  EntryReader list;
+  if(!list.open(patchesPath(absolute_path), what))
+  {
+    return false;
+  }
+
+  // The newest list is a superset of the older ones
+  entry_copy_t copy;
+  list.copy(std::numeric_limits<std::uint64_t>::max(), copy);
+  const std::string& strmem = copy.data;
+
+  relative_keys.clear();
+  std::size_t begin = 0;
+  while(begin < strmem.size())
+  {
+    std::size_t end = strmem.find('\n', begin);
+    if(end == std::string::npos)
+    {
+      end = strmem.size();
+    }
+    if(end > begin)
+    {
+      relative_keys.push_back(strmem.substr(begin, end - begin));
+    }
+    begin = end + 1;
+  }
+  return true;
+}
+
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
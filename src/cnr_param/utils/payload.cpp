@@ -0,0 +1,222 @@
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <cnr_param/utils/payload.h>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+
+namespace
+{
+
+template<typename S>
+YAML::Node to_scalar_node(const char* coeffs, std::size_t i)
+{
+  S v;
+  std::memcpy(&v, coeffs + i * sizeof(S), sizeof(S));
+
+  // shortest round-trip representation, as the values written by 'set'
+  char buf[64];
+  auto res = std::to_chars(buf, buf + sizeof(buf), v);
+  return YAML::Node(std::string(buf, res.ptr));
+}
+
+YAML::Node to_scalar_node(scalar_t scalar, const char* coeffs, std::size_t i)
+{
+  switch(scalar)
+  {
+    case scalar_t::float64: return to_scalar_node<double>(coeffs, i);
+    case scalar_t::float32: return to_scalar_node<float>(coeffs, i);
+    case scalar_t::int64:   return to_scalar_node<std::int64_t>(coeffs, i);
+    case scalar_t::int32:   return to_scalar_node<std::int32_t>(coeffs, i);
+    case scalar_t::int16:   return to_scalar_node<std::int16_t>(coeffs, i);
+    case scalar_t::uint8:   return to_scalar_node<std::uint8_t>(coeffs, i);
+    default: return YAML::Node();
+  }
+}
+
+/**
+ * @brief Append the number of the scalar node to the coefficients, as S
+ *
+ * @return false, with 'what' empty, if the node is not a number; false, with 'what' set, if the number is not
+ * representable in S
+ */
+template<typename S>
+bool append_coeff(const YAML::Node& node, std::string& coeffs, std::string& what)
+{
+  const std::string& scalar = node.Scalar();
+  double v = 0;
+  if(!node.IsScalar() || (!parse_number(scalar.data(), scalar.data() + scalar.size(), v)
+                            && !YAML::convert<double>::decode(node, v)))
+  {
+    return false;
+  }
+
+  bool fits = true;
+  if constexpr(std::is_integral<S>::value)
+  {
+    fits = std::trunc(v) == v && v >= double(std::numeric_limits<S>::min())
+        && v < double(std::numeric_limits<S>::max()) + 1.0;
+  }
+  else
+  {
+    fits = !std::isfinite(v) || std::abs(v) <= double(std::numeric_limits<S>::max());
+  }
+  if(!fits)
+  {
+    what = "The value '" + scalar + "' cannot be stored as " + (std::is_integral<S>::value ? "an integer" : "a float")
+      + " of " + std::to_string(sizeof(S) * 8) + " bits";
+    return false;
+  }
+
+  const S s = static_cast<S>(v);
+  coeffs.append(reinterpret_cast<const char*>(&s), sizeof(S));
+  return true;
+}
+
+bool append_coeff(scalar_t scalar, const YAML::Node& node, std::string& coeffs, std::string& what)
+{
+  switch(scalar)
+  {
+    case scalar_t::float64: return append_coeff<double>(node, coeffs, what);
+    case scalar_t::float32: return append_coeff<float>(node, coeffs, what);
+    case scalar_t::int64:   return append_coeff<std::int64_t>(node, coeffs, what);
+    case scalar_t::int32:   return append_coeff<std::int32_t>(node, coeffs, what);
+    case scalar_t::int16:   return append_coeff<std::int16_t>(node, coeffs, what);
+    case scalar_t::uint8:   return append_coeff<std::uint8_t>(node, coeffs, what);
+    default: return false;
+  }
+}
+
+}  // namespace
+
+bool matrix_to_yaml(const char* data, std::size_t size, YAML::Node& node, std::string& what)
+{
+  if(size < sizeof(matrix_header_t))
+  {
+    what = "The binary payload is truncated";
+    return false;
+  }
+  matrix_header_t header;
+  std::memcpy(&header, data, sizeof(matrix_header_t));
+
+  const scalar_t scalar = static_cast<scalar_t>(header.scalar);
+  const std::size_t rows = static_cast<std::size_t>(header.rows);
+  const std::size_t cols = static_cast<std::size_t>(header.cols);
+  if(header.rows < 0 || header.cols < 0 || scalar_size(scalar) == 0
+    || size < sizeof(matrix_header_t) + rows * cols * scalar_size(scalar))
+  {
+    what = "The binary payload is corrupted";
+    return false;
+  }
+
+  const char* coeffs = data + sizeof(matrix_header_t);
+  const bool row_major = header.flags & matrix_flags::row_major;
+  node = YAML::Node(YAML::NodeType::Sequence);
+  if(header.flags & matrix_flags::vector)
+  {
+    for(std::size_t i = 0; i < rows * cols; i++)
+    {
+      node.push_back(to_scalar_node(scalar, coeffs, i));
+    }
+    return true;
+  }
+
+  for(std::size_t i = 0; i < rows; i++)
+  {
+    YAML::Node row(YAML::NodeType::Sequence);
+    for(std::size_t j = 0; j < cols; j++)
+    {
+      row.push_back(to_scalar_node(scalar, coeffs, row_major ? i * cols + j : j * rows + i));
+    }
+    node.push_back(row);
+  }
+  return true;
+}
+
+bool pod_to_yaml(const char* data, std::size_t size, YAML::Node& node, std::string& what)
+{
+  if(size < sizeof(pod_header_t))
+  {
+    what = "The POD payload is truncated";
+    return false;
+  }
+  pod_header_t header;
+  std::memcpy(&header, data, sizeof(pod_header_t));
+  if(size < sizeof(pod_header_t) + header.size)
+  {
+    what = "The POD payload is corrupted";
+    return false;
+  }
+  node = YAML::Node(YAML::Binary(reinterpret_cast<const unsigned char*>(data + sizeof(pod_header_t)),
+                                 static_cast<std::size_t>(header.size)));
+  return true;
+}
+
+scalar_t storage_tag(const YAML::Node& node)
+{
+  const std::string& tag = node.Tag();
+  return tag == "!float32" ? scalar_t::float32
+       : tag == "!int16"   ? scalar_t::int16
+       : tag == "!uint8"   ? scalar_t::uint8
+       :                     scalar_t::none;
+}
+
+bool yaml_to_matrix(const YAML::Node& node, scalar_t scalar, std::string& payload, std::string& what)
+{
+  what.clear();
+  if(!node.IsSequence() || node.size() == 0 || scalar_size(scalar) == 0)
+  {
+    return false;
+  }
+
+  // a vector is stored as a column, a table as a row-major matrix
+  const bool table = node[0].IsSequence();
+  matrix_header_t header;
+  header.scalar   = static_cast<std::uint32_t>(scalar);
+  header.flags    = table ? matrix_flags::row_major : matrix_flags::vector;
+  header.rows     = static_cast<std::int64_t>(node.size());
+  header.cols     = table ? static_cast<std::int64_t>(node[0].size()) : 1;
+  header.reserved = 0;
+
+  std::string coeffs;
+  coeffs.reserve(static_cast<std::size_t>(header.rows * header.cols) * scalar_size(scalar));
+  for(const auto& item : node)
+  {
+    if(!table)
+    {
+      if(!append_coeff(scalar, item, coeffs, what))
+      {
+        return false;
+      }
+      continue;
+    }
+    if(!item.IsSequence() || static_cast<std::int64_t>(item.size()) != header.cols)
+    {
+      return false;
+    }
+    for(const auto& coeff : item)
+    {
+      if(!append_coeff(scalar, coeff, coeffs, what))
+      {
+        return false;
+      }
+    }
+  }
+
+  payload.assign(reinterpret_cast<const char*>(&header), sizeof(matrix_header_t));
+  payload += coeffs;
+  return true;
+}
+
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <string>
+
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cnr_param/utils/stats.h>
+
+namespace cnr
+{
+namespace param
+{
+namespace utils
+{
+namespace stats
+{
+
+namespace
+{
+
+constexpr char stats_magic[8] = {'C', 'N', 'R', 'P', 'S', 'T', 'A', 'T'};
+
+/**
+ * @brief The segment of the process. After a fork, the child creates its own segment at its first call.
+ */
+struct Process
+{
+  std::mutex mutex;
+  std::atomic<stats_segment_t*> segment{nullptr};
+  std::atomic<bool> failed{false};
+  std::atomic<std::uint64_t> epoch{0};  // incremented at each fork, to reassign the thread slots
+  std::string path;
+  pid_t owner = 0;
+
+  Process();
+  ~Process()
+  {
+    // The mapping is kept, since other threads may still record; only the file is removed
+    if(owner == getpid() && !path.empty())
+    {
+      boost::system::error_code ec;
+      boost::filesystem::remove(path, ec);
+    }
+  }
+};
+
+Process& process()
+{
+  static Process p;
+  return p;
+}
+
+Process::Process()
+{
+  pthread_atfork([]() { process().mutex.lock(); },
+                 []() { process().mutex.unlock(); },
+                 []() {
+                   Process& p = process();
+                   p.segment.store(nullptr, std::memory_order_relaxed);
+                   p.failed.store(false, std::memory_order_relaxed);
+                   p.epoch.fetch_add(1, std::memory_order_relaxed);
+                   p.path.clear();
+                   p.mutex.unlock();
+                 });
+}
+
+std::string processName()
+{
+  std::ifstream comm("/proc/self/comm");
+  std::string name;
+  if(!comm || !std::getline(comm, name))
+  {
+    name = "pid " + std::to_string(getpid());
+  }
+  return name;
+}
+
+/**
+ * @brief Remove the segments of the processes that are no more running (e.g., crashed, or killed), so that the
+ * directory does not grow across the restarts
+ */
+void removeDeadSegments(const boost::filesystem::path& dir)
+{
+  boost::system::error_code ec;
+  for(boost::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+  {
+    const std::string name = it->path().filename().string();
+    if(name.empty() || !std::all_of(name.begin(), name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+    {
+      continue;
+    }
+    const pid_t pid = static_cast<pid_t>(std::strtol(name.c_str(), nullptr, 10));
+    if(pid > 0 && pid != getpid() && kill(pid, 0) != 0 && errno == ESRCH)
+    {
+      boost::system::error_code rm_ec;
+      boost::filesystem::remove(it->path(), rm_ec);
+    }
+  }
+}
+
+stats_segment_t* create(Process& p)
+{
+  const char* env_p = std::getenv("CNR_PARAM_ROOT_DIRECTORY");
+  if(!env_p)
+  {
+    return nullptr;
+  }
+
+  try
+  {
+    const boost::filesystem::path dir(statsDirectory(env_p));
+    boost::filesystem::create_directories(dir);
+    removeDeadSegments(dir);
+    const std::string path = (dir / std::to_string(getpid())).string();
+    {
+      std::filebuf fbuf;
+      if(!fbuf.open(path, std::ios_base::in | std::ios_base::out | std::ios_base::trunc | std::ios_base::binary))
+      {
+        return nullptr;
+      }
+      fbuf.pubseekoff(sizeof(stats_segment_t) - 1, std::ios_base::beg);
+      fbuf.sputc(0);
+    }
+
+    boost::interprocess::file_mapping file(path.c_str(), boost::interprocess::read_write);
+    auto* region = new boost::interprocess::mapped_region(file, boost::interprocess::read_write, 0,
+                                                          sizeof(stats_segment_t));
+    auto* segment = static_cast<stats_segment_t*>(region->get_address());
+    segment->version = stats_version;
+    segment->pid = static_cast<std::int32_t>(getpid());
+    segment->start_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count());
+    std::strncpy(segment->process, processName().c_str(), sizeof(segment->process) - 1);
+
+    // the magic is the last field written, the readers skip the segments not yet initialized
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(segment->magic, stats_magic, sizeof(stats_magic));
+
+    p.path = path;
+    p.owner = getpid();
+    return segment;
+  }
+  catch(std::exception&)
+  {
+    return nullptr;
+  }
+}
+
+stats_segment_t* segment()
+{
+  Process& p = process();
+  stats_segment_t* s = p.segment.load(std::memory_order_acquire);
+  if(s || p.failed.load(std::memory_order_relaxed))
+  {
+    return s;
+  }
+
+  std::lock_guard<std::mutex> lock(p.mutex);
+  s = p.segment.load(std::memory_order_acquire);
+  if(!s && !p.failed.load(std::memory_order_relaxed))
+  {
+    s = create(p);
+    p.failed.store(s == nullptr, std::memory_order_relaxed);
+    p.segment.store(s, std::memory_order_release);
+  }
+  return s;
+}
+
+thread_stats_t* threadSlot(stats_segment_t* s)
+{
+  thread_local std::uint64_t epoch = std::numeric_limits<std::uint64_t>::max();
+  thread_local thread_stats_t* slot = nullptr;
+
+  const std::uint64_t e = process().epoch.load(std::memory_order_relaxed);
+  if(epoch != e || !slot)
+  {
+    std::uint32_t i = s->threads.fetch_add(1, std::memory_order_relaxed);
+    slot = &s->thread[std::min<std::size_t>(i, max_threads - 1)];
+    epoch = e;
+  }
+  return slot;
+}
+
+key_stats_t* keySlot(stats_segment_t* s, const std::string& key)
+{
+  // FNV-1a
+  std::uint64_t h = 14695981039346656037ull;
+  for(const char c : key)
+  {
+    h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+  }
+  h = h ? h : 1;
+
+  constexpr std::size_t max_probes = 16;
+  for(std::size_t i = 0; i < max_probes; i++)
+  {
+    key_stats_t& k = s->keys[(h + i) % max_keys];
+    std::uint64_t current = k.hash.load(std::memory_order_acquire);
+    if(current == 0 && k.hash.compare_exchange_strong(current, h, std::memory_order_acq_rel))
+    {
+      std::strncpy(k.key, key.c_str(), max_key_length - 1);
+      k.ready.store(1, std::memory_order_release);
+      return &k;
+    }
+    if(current == h)
+    {
+      return &k;
+    }
+  }
+  s->dropped.fetch_add(1, std::memory_order_relaxed);
+  return nullptr;
+}
+
+std::size_t bucket(std::uint64_t ns)
+{
+  return ns ? std::min<std::size_t>(latency_buckets - 1, 63 - static_cast<std::size_t>(__builtin_clzll(ns))) : 0;
+}
+
+}  // namespace
+
+std::string statsDirectory(const std::string& root_directory)
+{
+  return (boost::filesystem::path(root_directory) / ".stats").string();
+}
+
+bool validSegment(const void* addr, std::size_t size)
+{
+  if(!addr || size < sizeof(stats_segment_t))
+  {
+    return false;
+  }
+  const auto* segment = static_cast<const stats_segment_t*>(addr);
+  const bool valid = std::memcmp(segment->magic, stats_magic, sizeof(stats_magic)) == 0
+                     && segment->version == stats_version;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return valid;
+}
+
+void record(op_t op, const std::string& key, std::uint64_t ns, bool ok)
+{
+  stats_segment_t* s = segment();
+  if(!s)
+  {
+    return;
+  }
+  const std::size_t i = static_cast<std::size_t>(op);
+
+  op_stats_t& o = threadSlot(s)->ops[i];
+  o.calls.fetch_add(1, std::memory_order_relaxed);
+  if(!ok)
+  {
+    o.errors.fetch_add(1, std::memory_order_relaxed);
+  }
+  o.ns.fetch_add(ns, std::memory_order_relaxed);
+  o.histogram[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+
+  key_stats_t* k = key.empty() ? nullptr : keySlot(s, key);
+  if(k)
+  {
+    k->calls[i].fetch_add(1, std::memory_order_relaxed);
+    if(!ok)
+    {
+      k->errors[i].fetch_add(1, std::memory_order_relaxed);
+    }
+    k->ns[i].fetch_add(ns, std::memory_order_relaxed);
+  }
+}
+
+void count(counter_t counter)
+{
+  stats_segment_t* s = segment();
+  if(s)
+  {
+    threadSlot(s)->counters[static_cast<std::size_t>(counter)].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace stats
+}  // namespace utils
+}  // namespace param
+}  // namespace cnr
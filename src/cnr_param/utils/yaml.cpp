@@ -3,6 +3,7 @@
 #include <yaml-cpp/yaml.h>
 
 #include <cnr_param/utils/filesystem.h>
+#include <cnr_param/utils/logger.h>
 #include <cnr_param/utils/string.h>
 #include <cnr_param/utils/yaml.h>
 
@@ -24,6 +25,12 @@ const YAML::Node merge_nodes(const YAML::Node& default_node,
   }
   // Create a new map 'new_node' with the same mappings as default_node, merged with override_node
   auto new_node = YAML::Node(YAML::NodeType::Map);
+  // The tags of the namespaces (e.g., the storage annotation '!float32') are kept, the overriding one first
+  auto tagged = [](const YAML::Node& node) { return !node.Tag().empty() && node.Tag() != "?" && node.Tag() != "!"; };
+  if(tagged(override_node) || tagged(default_node))
+  {
+    new_node.SetTag(tagged(override_node) ? override_node.Tag() : default_node.Tag());
+  }
   for (auto node : default_node) 
   {
     if (node.first.IsScalar())
@@ -135,17 +142,14 @@ void get_keys_tree(const std::string& ns, const YAML::Node& node, std::vector<st
   }
   catch(YAML::InvalidNode& e)
   {
-    std::cout << __LINE__ << "@" << l << ":" << e.what() << std::endl;
-    std::cout << "Input Node: \n" << node << std::endl;
-    std::cout << "Continue" << std::endl;
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": last executed line " << l << ": " << e.what());
+    CNR_PARAM_LOG_DEBUG("Input Node: \n" << node);
     assert(0);
   }
   catch(std::exception& e)
   {
-    std::cout << __LINE__ << "@" << l << ":" << e.what() << std::endl;
-    std::cout << "Input Node Type: " << node.Type() << std::endl;
-    std::cout << "Input Node: \n" << node << std::endl;
-    std::cout << "Continue" << std::endl;
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": last executed line " << l << ": " << e.what());
+    CNR_PARAM_LOG_DEBUG("Input Node Type: " << node.Type() << "\nInput Node: \n" << node);
     assert(0);
   }
   return;
@@ -181,17 +185,14 @@ void get_nodes_tree(const std::string& ns, const YAML::Node& node, std::vector<
   }
   catch(YAML::InvalidNode& e)
   {
-    std::cout << __LINE__ << "@" << l << ":" << e.what() << std::endl;
-    std::cout << "Input Node: \n" << node << std::endl;
-    std::cout << "Continue" << std::endl;
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": last executed line " << l << ": " << e.what());
+    CNR_PARAM_LOG_DEBUG("Input Node: \n" << node);
     assert(0);
   }
   catch(std::exception& e)
   {
-    std::cout << __LINE__ << "@" << l << ":" << e.what() << std::endl;
-    std::cout << "Input Node Type: " << node.Type() << std::endl;
-    std::cout << "Input Node: \n" << node << std::endl;
-    std::cout << "Continue" << std::endl;
+    CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": last executed line " << l << ": " << e.what());
+    CNR_PARAM_LOG_DEBUG("Input Node Type: " << node.Type() << "\nInput Node: \n" << node);
     assert(0);
   }
   return;
@@ -224,13 +225,15 @@ YAML::Node get_leaf(const std::vector<std::string>& keys, const YAML::Node& node
       }
     }
   }
-  std::cout << "Weird error " << key << " < ";
-  for(YAML::const_iterator yt=node.begin(); yt!=node.end();++yt) 
-  {
-    const std::string& node_key = yt->first.as<std::string>();
-    std::cout << node_key << " ";
-  }
-  std::cout  << ">" <<std::endl;
+  CNR_PARAM_LOG_DEBUG("The key '" << key << "' is not a child of the node < "
+    << [&node]() {
+      std::string children;
+      for(YAML::const_iterator yt=node.begin(); yt!=node.end();++yt)
+      {
+        children += yt->first.as<std::string>() + " ";
+      }
+      return children;
+    }() << ">");
   return YAML::Node();
 }
 
@@ -8,6 +8,7 @@
 #include <boost/filesystem.hpp>
 
 #include <cnr_param_server/utils/args_parser.h>
+#include <cnr_param_server/utils/trace.h>
 #include <cnr_param_server/utils/yaml_manager.h>
 
 #if defined(_WIN32)
@@ -64,7 +65,13 @@ int main(int argc, char* argv[])
   }
 
   // Parsing of program inputs
+  const double start = Tracer::instance().now_us();
   ArgParser args(argc, argv, default_shmem_name);
+  if(!args.getTraceFile().empty())
+  {
+    Tracer::instance().enable(args.getTraceFile());
+    Tracer::instance().add({"ArgParser", "args", start, Tracer::instance().now_us() - start, Tracer::thread_id(), {}});
+  }
 
   // Parsing of the file contents, and storing in YAML::Node root
   YAMLParser yaml_parser(args.getNamespacesMap());
@@ -73,6 +80,12 @@ int main(int argc, char* argv[])
   // The tree is build under the 'param_root_directory'
   YAMLStreamer yaml_streamer(yaml_parser.root(), param_root_directory);
 
+  std::string what;
+  if(!Tracer::instance().flush(what))
+  {
+    std::cerr << what << std::endl;
+  }
+
   // Done!
   return 0;
 }
@@ -75,7 +75,10 @@ ArgParser::ArgParser(int argc, const char* const argv[], const std::string& defa
       ("help,h", "produce help message")
       ("config-file,c", 
         po::value< std::string>()->value_name("filepath absolute or relative"),
-        "config file name. It stores all the inline commands");
+        "config file name. It stores all the inline commands")
+      ("trace,t", 
+        po::value< std::string>()->value_name("filepath"),
+        "write the spans of the startup phases in a Chrome trace JSON file (chrome://tracing, ui.perfetto.dev)");
 
     shmem_options_.add_options()
       ("reset-all-ns,a", 
@@ -168,6 +171,11 @@ ArgParser::ArgParser(int argc, const char* const argv[], const std::string& defa
       }
     }
 
+    if(vm.count("trace"))
+    {
+      trace_file_ = vm["trace"].as<std::string>();
+    }
+
     if(vm.count("reset-all-ns"))
     {
       reset_all_ns_ = true;
@@ -301,6 +309,11 @@ const std::map<std::string, size_t>& ArgParser::getSizeMap() const
   return size_shmem_map_;
 }
 
+const std::string& ArgParser::getTraceFile() const
+{
+  return trace_file_;
+}
+
 std::map<std::string, std::vector<std::string> > ArgParser::getNamespacesMap() const
 {
   std::map<std::string, std::vector<std::string>> ret{};
@@ -0,0 +1,153 @@
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include <boost/interprocess/detail/os_thread_functions.hpp>
+
+#include <cnr_param_server/utils/trace.h>
+
+namespace
+{
+
+std::string escape(const std::string& str)
+{
+  std::string ret;
+  ret.reserve(str.size());
+  for(const char c : str)
+  {
+    switch(c)
+    {
+      case '"':  ret += "\\\""; break;
+      case '\\': ret += "\\\\"; break;
+      case '\n': ret += "\\n"; break;
+      case '\t': ret += "\\t"; break;
+      default:
+        if(static_cast<unsigned char>(c) < 0x20)
+        {
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+          ret += buf;
+        }
+        else
+        {
+          ret += c;
+        }
+    }
+  }
+  return ret;
+}
+
+}  // namespace
+
+Tracer& Tracer::instance()
+{
+  static Tracer tracer;
+  return tracer;
+}
+
+Tracer::Tracer() : enabled_(false), start_(std::chrono::steady_clock::now())
+{
+}
+
+void Tracer::enable(const std::string& path)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  path_ = path;
+  enabled_ = !path.empty();
+  if(!enabled_)
+  {
+    events_.clear();
+  }
+}
+
+double Tracer::now_us() const
+{
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_).count();
+}
+
+std::size_t Tracer::thread_id()
+{
+  return std::hash<std::thread::id>()(std::this_thread::get_id()) % 100000;
+}
+
+void Tracer::add(event_t&& event)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  events_.push_back(std::move(event));
+}
+
+bool Tracer::flush(std::string& what)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+  if(!enabled_)
+  {
+    return true;
+  }
+
+  std::ofstream out(path_);
+  if(!out)
+  {
+    what = "Error in opening the trace file '" + path_ + "'";
+    return false;
+  }
+
+  const auto pid = boost::interprocess::ipcdetail::get_current_process_id();
+  out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+  out << std::fixed << std::setprecision(3);
+  for(std::size_t i = 0; i < events_.size(); i++)
+  {
+    const auto& e = events_[i];
+    out << "{\"name\": \"" << escape(e.name) << "\", \"cat\": \"" << escape(e.category) << "\", \"ph\": \"X\", "
+        << "\"ts\": " << e.ts_us << ", \"dur\": " << e.dur_us << ", \"pid\": " << pid << ", \"tid\": " << e.tid;
+    if(!e.args.empty())
+    {
+      out << ", \"args\": {";
+      for(auto it = e.args.begin(); it != e.args.end(); ++it)
+      {
+        out << (it == e.args.begin() ? "" : ", ") << "\"" << escape(it->first) << "\": \"" << escape(it->second)
+            << "\"";
+      }
+      out << "}";
+    }
+    out << "}" << (i + 1 < events_.size() ? ",\n" : "\n");
+  }
+  out << "]}\n";
+  if(!out)
+  {
+    what = "Error in writing the trace file '" + path_ + "'";
+    return false;
+  }
+  return true;
+}
+
+TraceSpan::TraceSpan(const char* name, const char* category) : enabled_(Tracer::instance().enabled())
+{
+  if(enabled_)
+  {
+    event_.name = name;
+    event_.category = category;
+    event_.tid = Tracer::thread_id();
+    event_.ts_us = Tracer::instance().now_us();
+  }
+}
+
+TraceSpan::~TraceSpan()
+{
+  if(enabled_)
+  {
+    event_.dur_us = Tracer::instance().now_us() - event_.ts_us;
+    Tracer::instance().add(std::move(event_));
+  }
+}
+
+TraceSpan& TraceSpan::arg(const std::string& name, const std::string& value)
+{
+  if(enabled_)
+  {
+    event_.args[name] = value;
+  }
+  return *this;
+}
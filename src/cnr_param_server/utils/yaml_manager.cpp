@@ -21,7 +21,10 @@
 #include <cnr_param/utils/filesystem.h>
 #include <cnr_param/utils/yaml.h>
 #include <cnr_param/utils/interprocess.h>
+#include <cnr_param/utils/logger.h>
+#include <cnr_param/utils/payload.h>
 
+#include <cnr_param_server/utils/trace.h>
 #include <cnr_param_server/utils/yaml_manager.h>
 
 
@@ -32,8 +35,37 @@
 // ====================================================================================================
 // ====================================================================================================
 
+namespace
+{
+
+/**
+ * @brief The storage annotation of the key: its own tag, or the tag of the nearest annotated namespace
+ */
+cnr::param::utils::scalar_t storageOf(const std::vector<std::string>& keys, const YAML::Node& root)
+{
+  cnr::param::utils::scalar_t storage = cnr::param::utils::scalar_t::none;
+  YAML::Node node;
+  node.reset(root);
+  for(const auto& key : keys)
+  {
+    const YAML::Node& parent = node;
+    YAML::Node child = parent[key];
+    if(!child)
+    {
+      break;
+    }
+    node.reset(child);
+    const cnr::param::utils::scalar_t tag = cnr::param::utils::storage_tag(node);
+    storage = tag != cnr::param::utils::scalar_t::none ? tag : storage;
+  }
+  return storage;
+}
+
+}  // namespace
+
 YAMLParser::YAMLParser(const std::map<std::string, std::vector<std::string> >& nodes_map)
 {
+  TraceSpan span("YAMLParser", "parse");
   root_ = YAML::Node(YAML::NodeType::Map);
   for(const auto & node_pair : nodes_map)
   {
@@ -47,11 +79,18 @@ YAMLParser::YAMLParser(const std::map<std::string, std::vector<std::string> >& n
       // Each yaml file may be composed by different document, separated by 
       // the directives '---' and '...'
       // See https://camel.readthedocs.io/en/latest/yamlref.html
-      auto nodes = YAML::LoadAllFromFile(file);
+      std::vector<YAML::Node> nodes;
+      {
+        TraceSpan load("YAML::LoadAllFromFile", "parse");
+        load.arg("file", file);
+        nodes = YAML::LoadAllFromFile(file);
+      }
       
-      for(const auto & node : nodes) 
+      for(std::size_t i = 0; i < nodes.size(); i++) 
       {
-        YAML::Node new_node = cnr::param::utils::init_tree(ns, node);
+        TraceSpan merge("merge_nodes", "merge");
+        merge.arg("file", file).arg("document", std::to_string(i));
+        YAML::Node new_node = cnr::param::utils::init_tree(ns, nodes[i]);
         root_=cnr::param::utils::merge_nodes(root_, new_node);
       }
     }
@@ -67,6 +106,7 @@ const YAML::Node& YAMLParser::root() const
 YAMLStreamer::YAMLStreamer(const YAML::Node& root, const std::string& path_to_shared_files)
   : root_(root)
 {
+  TraceSpan span("YAMLStreamer", "publish");
   std::string what;
   boost::filesystem::path absolute_root_path; 
   if(!cnr::param::utils::dirpath(path_to_shared_files, absolute_root_path, what))
@@ -75,21 +115,35 @@ YAMLStreamer::YAMLStreamer(const YAML::Node& root, const std::string& path_to_sh
     throw std::runtime_error(err.c_str());
   }
 
-  if(!streamLeaf(absolute_root_path.string()))
+  // The whole tree is published with a single generation, so that the clients never see a partial tree
+  cnr::param::utils::GenerationLock lock(absolute_root_path.string());
+  if(!lock)
   {
-    throw std::runtime_error("Error in creating the shared file mapping");
+    throw std::runtime_error("Error in locking the root directory '" + absolute_root_path.string() + "'");
   }
-  if(!YAMLStreamer::streamNodes(absolute_root_path.string()))
+  generation_ = lock.next();
+
+  if(!streamLeaf(absolute_root_path.string()) || !YAMLStreamer::streamNodes(absolute_root_path.string()))
   {
+    for(const auto& absolute_path : written_)
+    {
+      cnr::param::utils::discardEntry(absolute_path, generation_);
+    }
     throw std::runtime_error("Error in creating the shared file mapping");
   }
+  lock.publish();
 }
 
 bool YAMLStreamer::streamLeaf(const std::string& absolute_root_path_string)
 {
+  TraceSpan span("streamLeaf", "publish");
   boost::filesystem::path absolute_root_path(absolute_root_path_string); 
 
-  std::map<std::string, std::vector<std::string> > tree = cnr::param::utils::toLeafMap(root_); //mapped file names;
+  std::map<std::string, std::vector<std::string> > tree;
+  {
+    TraceSpan to_leaf_map("toLeafMap", "publish");
+    tree = cnr::param::utils::toLeafMap(root_); //mapped file names;
+  }
 
   for(const auto & leaf : tree)
   {
@@ -100,6 +154,8 @@ bool YAMLStreamer::streamLeaf(const std::string& absolute_root_path_string)
       boost::filesystem::path rp = boost::filesystem::path(leaf.first) / fn;
       boost::filesystem::path ap = boost::filesystem::absolute(absolute_root_path / rp);
 
+      TraceSpan mapping("file mapping", "mapping");
+      mapping.arg("file", ap.string());
       auto l = __LINE__;
       try
       {
@@ -110,30 +166,23 @@ bool YAMLStreamer::streamLeaf(const std::string& absolute_root_path_string)
         std::string str = YAML::Dump(node);
 
         l = __LINE__;
-        auto regiorn = cnr::param::utils::createFileMapping(ap.string(),2*str.size());
-        if(!regiorn)
+        str +="\n";
+        cnr::param::utils::EntryWriter entry(ap.string(), cnr::param::utils::payload_t::yaml, str.size(), generation_);
+        if(!entry)
         {
           throw std::runtime_error("The file mapping cannot be created!");
         }
-        str +="\n";
 
-        if( str.size() > regiorn->get_size())
-        {
-          std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": BUG --- TO BE FIXED!!!! " << std::endl;
-          std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << ap << std::endl;
-          std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": Available Memory Size : " << regiorn->get_size() << " / Required Memory Size:" << str.size() << std::endl;
-          return false;
-        }
-        std::memcpy(regiorn->get_address(), str.c_str(), str.size() );
-        #if defined(NDEBUG)
-          cnr::param::utils::printMemoryContent(ap.string(), regiorn->get_address(), false);
-        #endif
+        std::memcpy(entry.data(), str.c_str(), str.size() );
+        entry.commit(str.size());
+        written_.push_back(ap.string());
+        cnr::param::utils::printMemoryContent(ap.string(), entry.data(), str.size(), false);
         
       }
       catch(std::exception& e)
       {
-        std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << ap << std::endl;
-        std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": last executed line " << l << ":" << e.what() << std::endl;
+        CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": Aboslute path: " << ap
+          << ", last executed line " << l << ": " << e.what());
         return false;
       }
     }
@@ -144,9 +193,14 @@ bool YAMLStreamer::streamLeaf(const std::string& absolute_root_path_string)
 
 bool YAMLStreamer::streamNodes(const std::string& absolute_root_path_string)
 {
+  TraceSpan span("streamNodes", "publish");
   boost::filesystem::path absolute_root_path(absolute_root_path_string); 
 
-  std::vector<std::pair<std::string,YAML::Node>> tree = cnr::param::utils::toNodeList(root_); //mapped file names;
+  std::vector<std::pair<std::string,YAML::Node>> tree;
+  {
+    TraceSpan to_node_list("toNodeList", "publish");
+    tree = cnr::param::utils::toNodeList(root_); //mapped file names;
+  }
 
   for(const auto & node : tree)
   {
@@ -154,35 +208,55 @@ bool YAMLStreamer::streamNodes(const std::string& absolute_root_path_string)
     
     boost::filesystem::path rp = boost::filesystem::path(node.first).string() + ".yaml";
     boost::filesystem::path ap = boost::filesystem::absolute(absolute_root_path / rp);
+    TraceSpan mapping("file mapping", "mapping");
+    mapping.arg("file", ap.string());
     auto l = __LINE__;
     try
     {
+      // The numeric sequences annotated as '!float32', '!int16' or '!uint8' are stored in binary
       l = __LINE__;
-      YAML::Node _node;
-      _node[keys.back()] = node.second;
-
-      l = __LINE__;
-      std::string str = YAML::Dump(_node);
-      str +="\n";
+      std::string str;
+      std::string err;
+      cnr::param::utils::payload_t type = cnr::param::utils::payload_t::yaml;
+      const cnr::param::utils::scalar_t storage = storageOf(keys, root_);
+      if(storage != cnr::param::utils::scalar_t::none
+        && cnr::param::utils::yaml_to_matrix(node.second, storage, str, err))
+      {
+        type = cnr::param::utils::payload_t::matrix;
+      }
+      else if(!err.empty())
+      {
+        throw std::runtime_error("The param '" + node.first + "': " + err);
+      }
+      else
+      {
+        YAML::Node _node;
+        _node[keys.back()] = node.second;
+        str = YAML::Dump(_node);
+        str +="\n";
+      }
       
       l = __LINE__;
-      auto region = cnr::param::utils::createFileMapping(ap.string(),2*str.size());
-      if(!region)
+      cnr::param::utils::EntryWriter entry(ap.string(), type, str.size(), generation_);
+      if(!entry)
       {
         throw std::runtime_error("The file mapping cannot be created!");
       }
 
       l = __LINE__;
-      std::memcpy(region->get_address(), str.c_str(), str.size() );
+      std::memcpy(entry.data(), str.c_str(), str.size() );
+      entry.commit(str.size());
+      written_.push_back(ap.string());
       
       l = __LINE__;
-      #if defined(NDEBUG)
-        cnr::param::utils::printMemoryContent(ap.string(), region->get_address(), false);
-      #endif
+      if(type == cnr::param::utils::payload_t::yaml)
+      {
+        cnr::param::utils::printMemoryContent(ap.string(), entry.data(), str.size(), false);
+      }
     }
     catch(std::exception& e)
     {
-      std::cerr << __PRETTY_FUNCTION__ << ":" << __LINE__ << ": last executed line " << l << ":" << e.what() << std::endl;
+      CNR_PARAM_LOG_ERROR(__PRETTY_FUNCTION__ << ":" << __LINE__ << ": last executed line " << l << ": " << e.what());
       return false;
     }
   }
@@ -0,0 +1,338 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/program_options.hpp>
+
+#include <cnr_param/utils/colors.h>
+#include <cnr_param/utils/stats.h>
+
+namespace po = boost::program_options;
+namespace stats = cnr::param::utils::stats;
+
+/**
+ * Live monitor of the clients of the params stored under a root directory. It reads only the stats segments of the
+ * processes (see cnr_param/utils/stats.h), never the params, so it does not load the server it observes.
+ * The clients must be built with -DENABLE_STATS=ON.
+ */
+
+namespace
+{
+
+constexpr std::size_t ops = static_cast<std::size_t>(stats::op_t::count);
+constexpr std::size_t counters = static_cast<std::size_t>(stats::counter_t::count);
+
+struct op_sample_t
+{
+  std::uint64_t calls = 0;
+  std::uint64_t errors = 0;
+  std::uint64_t ns = 0;
+  std::uint64_t histogram[stats::latency_buckets] = {0};
+};
+
+struct key_sample_t
+{
+  std::uint64_t calls[ops] = {0};
+  std::uint64_t errors[ops] = {0};
+  std::uint64_t ns[ops] = {0};
+};
+
+/**
+ * @brief Copy of the counters of a process
+ */
+struct sample_t
+{
+  std::int32_t pid = 0;
+  std::uint64_t start_ns = 0;
+  std::string process;
+  op_sample_t op[ops];
+  std::uint64_t counter[counters] = {0};
+  std::uint64_t dropped = 0;
+  std::map<std::string, key_sample_t> keys;
+};
+
+bool alive(std::int32_t pid)
+{
+  return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+bool read(const boost::filesystem::path& path, sample_t& sample)
+{
+  try
+  {
+    boost::interprocess::file_mapping file(path.string().c_str(), boost::interprocess::read_only);
+    boost::interprocess::mapped_region region(file, boost::interprocess::read_only);
+    if(!stats::validSegment(region.get_address(), region.get_size()))
+    {
+      return false;
+    }
+    const auto* segment = static_cast<const stats::stats_segment_t*>(region.get_address());
+    if(!alive(segment->pid))
+    {
+      return false;
+    }
+
+    sample.pid = segment->pid;
+    sample.start_ns = segment->start_ns;
+    sample.process = std::string(segment->process, strnlen(segment->process, sizeof(segment->process)));
+    sample.dropped = segment->dropped.load(std::memory_order_relaxed);
+    const std::size_t threads = std::min<std::size_t>(segment->threads.load(std::memory_order_relaxed),
+                                                      stats::max_threads);
+    for(std::size_t t = 0; t < threads; t++)
+    {
+      const auto& thread = segment->thread[t];
+      for(std::size_t o = 0; o < ops; o++)
+      {
+        sample.op[o].calls += thread.ops[o].calls.load(std::memory_order_relaxed);
+        sample.op[o].errors += thread.ops[o].errors.load(std::memory_order_relaxed);
+        sample.op[o].ns += thread.ops[o].ns.load(std::memory_order_relaxed);
+        for(std::size_t b = 0; b < stats::latency_buckets; b++)
+        {
+          sample.op[o].histogram[b] += thread.ops[o].histogram[b].load(std::memory_order_relaxed);
+        }
+      }
+      for(std::size_t c = 0; c < counters; c++)
+      {
+        sample.counter[c] += thread.counters[c].load(std::memory_order_relaxed);
+      }
+    }
+    for(const auto& k : segment->keys)
+    {
+      if(!k.ready.load(std::memory_order_acquire))
+      {
+        continue;
+      }
+      key_sample_t& ks = sample.keys[std::string(k.key, strnlen(k.key, stats::max_key_length))];
+      for(std::size_t o = 0; o < ops; o++)
+      {
+        ks.calls[o] += k.calls[o].load(std::memory_order_relaxed);
+        ks.errors[o] += k.errors[o].load(std::memory_order_relaxed);
+        ks.ns[o] += k.ns[o].load(std::memory_order_relaxed);
+      }
+    }
+    return true;
+  }
+  catch(std::exception&)
+  {
+    return false;
+  }
+}
+
+/**
+ * @brief Percentile of the latency in us, from the log2 histogram of the calls between two samples
+ */
+double percentile(const op_sample_t& now, const op_sample_t& before, double p)
+{
+  std::uint64_t total = 0;
+  for(std::size_t b = 0; b < stats::latency_buckets; b++)
+  {
+    total += now.histogram[b] - before.histogram[b];
+  }
+  if(total == 0)
+  {
+    return 0.0;
+  }
+  const auto target = static_cast<std::uint64_t>(std::ceil(p * double(total)));
+  std::uint64_t count = 0;
+  for(std::size_t b = 0; b < stats::latency_buckets; b++)
+  {
+    count += now.histogram[b] - before.histogram[b];
+    if(count >= target)
+    {
+      return double(std::uint64_t(1) << (b + 1)) * 1e-3;  // upper bound of the bucket
+    }
+  }
+  return 0.0;
+}
+
+std::string fixed(double v, int precision = 1)
+{
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(precision) << v;
+  return ss.str();
+}
+
+void print(const std::map<std::int32_t, sample_t>& now, const std::map<std::int32_t, sample_t>& before,
+           double seconds, std::size_t top, bool clear)
+{
+  using cnr::param::utils::BOLDWHITE;
+  using cnr::param::utils::RESET;
+  const sample_t none;
+  const std::size_t get = static_cast<std::size_t>(stats::op_t::get);
+  const std::size_t set = static_cast<std::size_t>(stats::op_t::set);
+  const std::size_t has = static_cast<std::size_t>(stats::op_t::has);
+  const std::size_t hit = static_cast<std::size_t>(stats::counter_t::snapshot_hit);
+  const std::size_t miss = static_cast<std::size_t>(stats::counter_t::snapshot_miss);
+  const std::size_t retry = static_cast<std::size_t>(stats::counter_t::retry);
+
+  std::stringstream out;
+  if(clear)
+  {
+    out << "\033[H\033[2J";
+  }
+  out << BOLDWHITE() << "cnr_param_top" << RESET() << " - " << now.size() << " processes, rates "
+      << (before.empty() ? std::string("since the start of each process") : "over " + fixed(seconds) + " s")
+      << std::endl << std::endl;
+
+  out << BOLDWHITE() << std::left << std::setw(8) << "PID" << std::setw(18) << "PROCESS" << std::right
+      << std::setw(10) << "get/s" << std::setw(10) << "set/s" << std::setw(10) << "has/s" << std::setw(10)
+      << "err/s" << std::setw(12) << "get p50 us" << std::setw(12) << "get p99 us" << std::setw(12)
+      << "set p99 us" << std::setw(8) << "hit %" << std::setw(10) << "retry/s" << RESET() << std::endl;
+
+  struct key_rate_t
+  {
+    double get = 0;
+    double set = 0;
+    double errors = 0;
+    std::uint64_t calls = 0;
+    std::uint64_t ns = 0;
+    std::size_t processes = 0;
+  };
+  std::map<std::string, key_rate_t> keys;
+  for(const auto& p : now)
+  {
+    const sample_t& n = p.second;
+    auto it = before.find(p.first);
+    const sample_t& b = (it != before.end() && it->second.start_ns == n.start_ns) ? it->second : none;
+    const double dt = &b == &none ? std::max(1e-9, double(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count() - n.start_ns) * 1e-9) : seconds;
+
+    std::uint64_t errors = 0;
+    for(std::size_t o = 0; o < ops; o++)
+    {
+      errors += n.op[o].errors - b.op[o].errors;
+    }
+    const std::uint64_t hits = n.counter[hit] - b.counter[hit];
+    const std::uint64_t misses = n.counter[miss] - b.counter[miss];
+
+    out << std::left << std::setw(8) << n.pid << std::setw(18) << n.process.substr(0, 17) << std::right
+        << std::setw(10) << fixed(double(n.op[get].calls - b.op[get].calls) / dt)
+        << std::setw(10) << fixed(double(n.op[set].calls - b.op[set].calls) / dt)
+        << std::setw(10) << fixed(double(n.op[has].calls - b.op[has].calls) / dt)
+        << std::setw(10) << fixed(double(errors) / dt)
+        << std::setw(12) << fixed(percentile(n.op[get], b.op[get], 0.5))
+        << std::setw(12) << fixed(percentile(n.op[get], b.op[get], 0.99))
+        << std::setw(12) << fixed(percentile(n.op[set], b.op[set], 0.99))
+        << std::setw(8) << (hits + misses ? fixed(100.0 * double(hits) / double(hits + misses)) : std::string("-"))
+        << std::setw(10) << fixed(double(n.counter[retry] - b.counter[retry]) / dt) << std::endl;
+
+    for(const auto& k : n.keys)
+    {
+      auto kb = b.keys.find(k.first);
+      const key_sample_t zero;
+      const key_sample_t& ks = kb != b.keys.end() ? kb->second : zero;
+      key_rate_t& r = keys[k.first];
+      r.get += double(k.second.calls[get] - ks.calls[get]) / dt;
+      r.set += double(k.second.calls[set] - ks.calls[set]) / dt;
+      bool active = false;
+      for(std::size_t o = 0; o < ops; o++)
+      {
+        r.errors += double(k.second.errors[o] - ks.errors[o]) / dt;
+        active |= k.second.calls[o] != ks.calls[o];
+      }
+      r.calls += k.second.calls[get] - ks.calls[get];
+      r.ns += k.second.ns[get] - ks.ns[get];
+      r.processes += active ? 1 : 0;
+    }
+  }
+
+  std::vector<std::pair<std::string, key_rate_t>> hottest(keys.begin(), keys.end());
+  std::sort(hottest.begin(), hottest.end(), [](const auto& a, const auto& b)
+  {
+    return a.second.get + a.second.set > b.second.get + b.second.set;
+  });
+  hottest.resize(std::min(top, hottest.size()));
+
+  out << std::endl << BOLDWHITE() << std::left << std::setw(48) << "KEY" << std::right << std::setw(10) << "get/s"
+      << std::setw(10) << "set/s" << std::setw(10) << "err/s" << std::setw(14) << "get mean us" << std::setw(8)
+      << "procs" << RESET() << std::endl;
+  for(const auto& k : hottest)
+  {
+    const std::string key = k.first.size() > 47 ? "..." + k.first.substr(k.first.size() - 44) : k.first;
+    out << std::left << std::setw(48) << key << std::right << std::setw(10) << fixed(k.second.get)
+        << std::setw(10) << fixed(k.second.set) << std::setw(10) << fixed(k.second.errors)
+        << std::setw(14) << (k.second.calls ? fixed(double(k.second.ns) / double(k.second.calls) * 1e-3) : "-")
+        << std::setw(8) << k.second.processes << std::endl;
+  }
+  std::cout << out.str() << std::flush;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  std::string root;
+  double interval = 1.0;
+  std::size_t iterations = 0;
+  std::size_t top = 20;
+
+  const char* env_p = std::getenv("CNR_PARAM_ROOT_DIRECTORY");
+  po::options_description options("Live monitor of the clients of cnr_param", 160);
+  options.add_options()
+    ("help,h", "produce help message")
+    ("root,r", po::value<std::string>(&root)->default_value(env_p ? env_p : "/tmp/cnr_param"),
+      "root directory of the params, CNR_PARAM_ROOT_DIRECTORY by default")
+    ("interval,d", po::value<double>(&interval)->default_value(interval), "seconds between two refreshes")
+    ("iterations,n", po::value<std::size_t>(&iterations)->default_value(iterations),
+      "number of refreshes, 0 to run until interrupted")
+    ("keys,k", po::value<std::size_t>(&top)->default_value(top), "number of hottest keys shown");
+
+  try
+  {
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, options), vm);
+    po::notify(vm);
+    if(vm.count("help"))
+    {
+      std::cout << options << std::endl;
+      return 0;
+    }
+  }
+  catch(std::exception& e)
+  {
+    std::cerr << e.what() << std::endl << options << std::endl;
+    return 1;
+  }
+
+  const boost::filesystem::path dir(stats::statsDirectory(root));
+  const bool clear = iterations != 1;
+  std::map<std::int32_t, sample_t> before;
+  auto last = std::chrono::steady_clock::now();
+  for(std::size_t i = 0; iterations == 0 || i < iterations; i++)
+  {
+    if(i > 0)
+    {
+      std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+    }
+    std::map<std::int32_t, sample_t> now;
+    boost::system::error_code ec;
+    for(boost::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+    {
+      sample_t sample;
+      if(read(it->path(), sample))
+      {
+        now[sample.pid] = std::move(sample);
+      }
+    }
+    const auto t = std::chrono::steady_clock::now();
+    print(now, before, std::chrono::duration<double>(t - last).count(), top, clear);
+    before = std::move(now);
+    last = t;
+  }
+  return 0;
+}
@@ -1,15 +1,34 @@
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <cstdlib>
+#include <limits>
 #include <ostream>
 #include <utility>
 #include <iostream>
 #include <string>
 #include <iostream>
 
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include <boost/interprocess/detail/os_file_functions.hpp>
 
 #include <cnr_param/cnr_param.h>
+#include <cnr_param/bind.h>
+#include <cnr_param/block.h>
+#include <cnr_param/utils/logger.h>
+#include <cnr_param/utils/numbers.h>
 
 #include <cnr_param_server/utils/args_parser.h>
+#include <cnr_param_server/utils/trace.h>
 #include <cnr_param_server/utils/yaml_manager.h>
 
 #include <gtest/gtest.h>
@@ -137,6 +156,121 @@ TEST(ServerTest, ServerUsage)
   EXPECT_NO_FATAL_FAILURE(delete args);
 }
 
+TEST(ServerTest, Trace)
+{
+  std::string what;
+  const std::string trace = param_root_directory + "/server_trace.json";
+  Tracer::instance().enable(trace);
+  struct Disable
+  {
+    ~Disable() { Tracer::instance().enable(""); }
+  } disable;  // the next tests run without tracing, also if an assertion fails
+
+  std::string fn = std::string(TEST_DIR) + "/example.config";
+  const char* const argv[] = {"test", "--config", fn.c_str()};
+  ArgParser args(3, argv, "param_server_default_shmem");
+  YAMLParser yaml_parser(args.getNamespacesMap());
+  YAMLStreamer yaml_streamer(yaml_parser.root(), param_root_directory);
+  EXPECT_TRUE(Tracer::instance().flush(what)) << what;
+
+  // the JSON is valid YAML
+  YAML::Node json = YAML::LoadFile(trace);
+  ASSERT_TRUE(json["traceEvents"].IsSequence());
+  std::map<std::string, int> spans;
+  for(const auto& event : json["traceEvents"])
+  {
+    EXPECT_EQ(event["ph"].as<std::string>(), "X");
+    EXPECT_GE(event["dur"].as<double>(), 0.0);
+    spans[event["name"].as<std::string>()]++;
+  }
+  EXPECT_EQ(spans["YAMLParser"], 1);
+  EXPECT_EQ(spans["YAMLStreamer"], 1);
+  EXPECT_EQ(spans["toLeafMap"], 1);
+  EXPECT_EQ(spans["toNodeList"], 1);
+  EXPECT_GE(spans["YAML::LoadAllFromFile"], 1);
+  EXPECT_GE(spans["merge_nodes"], 1);
+  EXPECT_GT(spans["file mapping"], 1);
+}
+
+TEST(ServerTest, NarrowStorage)
+{
+  std::string what;
+  const YAML::Node root = YAML::Load(
+    "narrow:\n"
+    "  costmap: !float32\n"
+    "  - [0.5, 0.25, 1e-3]\n"
+    "  - [1, 2, 3]\n"
+    "  labels: !uint8 [0, 1, 255]\n"
+    "  offsets: !int16 [-300, 0, 300]\n"
+    "  maps: !float32\n"
+    "    occupancy: [0.1, 0.2]\n"
+    "    names: [a, b]\n"
+    "    nested: {grid: [[1, 2], [3, 4]]}\n"
+    "  plain: [0.1, 0.2]\n");
+  EXPECT_TRUE(does_not_throw([&]{ YAMLStreamer streamer(root, param_root_directory); }));
+
+  // the Eigen objects of the same scalar are copied, the other types are converted
+  Eigen::MatrixXf costmap_f;
+  EXPECT_TRUE(cnr::param::get("/narrow/costmap", costmap_f, what)) << what;
+  ASSERT_EQ(costmap_f.rows(), 2);
+  ASSERT_EQ(costmap_f.cols(), 3);
+  EXPECT_EQ(costmap_f(0, 2), 1e-3f);
+  EXPECT_EQ(costmap_f(1, 0), 1.0f);
+
+  cnr::param::Matrix<float> table;
+  EXPECT_TRUE(cnr::param::get("/narrow/costmap", table, what)) << what;
+  EXPECT_EQ(table(0, 1), 0.25f);
+  std::vector<std::vector<double>> costmap_d;
+  EXPECT_TRUE(cnr::param::get("/narrow/costmap", costmap_d, what)) << what;
+  EXPECT_EQ(costmap_d[0][2], double(1e-3f));
+
+  Eigen::Matrix<std::uint8_t, Eigen::Dynamic, 1> labels;
+  EXPECT_TRUE(cnr::param::get("/narrow/labels", labels, what)) << what;
+  EXPECT_EQ(labels(2), 255);
+  std::vector<int> labels_i;
+  EXPECT_TRUE(cnr::param::get("/narrow/labels", labels_i, what)) << what;
+  EXPECT_EQ(labels_i, std::vector<int>({0, 1, 255}));
+
+  std::vector<short> offsets;
+  EXPECT_TRUE(cnr::param::get("/narrow/offsets", offsets, what)) << what;
+  EXPECT_EQ(offsets, std::vector<short>({-300, 0, 300}));
+  std::vector<unsigned int> offsets_u;
+  EXPECT_FALSE(cnr::param::get("/narrow/offsets", offsets_u, what));
+
+  // the Eigen objects are checked as the vectors
+  Eigen::MatrixXi costmap_i;
+  EXPECT_FALSE(cnr::param::get("/narrow/costmap", costmap_i, what));
+  Eigen::Matrix<std::uint8_t, Eigen::Dynamic, 1> offsets_u8;
+  EXPECT_FALSE(cnr::param::get("/narrow/offsets", offsets_u8, what));
+  Eigen::VectorXi offsets_i;
+  EXPECT_TRUE(cnr::param::get("/narrow/offsets", offsets_i, what)) << what;
+  EXPECT_EQ(offsets_i(0), -300);
+
+  // the annotation of a namespace applies to its numeric sequences
+  std::vector<double> occupancy;
+  EXPECT_TRUE(cnr::param::get("/narrow/maps/occupancy", occupancy, what)) << what;
+  EXPECT_EQ(occupancy, std::vector<double>({double(0.1f), double(0.2f)}));
+  std::vector<std::string> names;
+  EXPECT_TRUE(cnr::param::get("/narrow/maps/names", names, what)) << what;
+  EXPECT_EQ(names, std::vector<std::string>({"a", "b"}));
+  cnr::param::Matrix<int> grid;
+  EXPECT_TRUE(cnr::param::get("/narrow/maps/nested/grid", grid, what)) << what;
+  EXPECT_EQ(grid(1, 1), 4);
+  YAML::Node maps;
+  EXPECT_TRUE(cnr::param::get("/narrow/maps", maps, what)) << what;
+  EXPECT_TRUE(maps["occupancy"].IsSequence());
+
+  std::vector<double> plain;
+  EXPECT_TRUE(cnr::param::get("/narrow/plain", plain, what)) << what;
+  EXPECT_EQ(plain, std::vector<double>({0.1, 0.2}));
+
+  // the values that do not fit the annotation are rejected by the server
+  EXPECT_FALSE(does_not_throw([&]{ YAMLStreamer streamer(YAML::Load("narrow_bad: {v: !uint8 [256]}"),
+                                                          param_root_directory); }));
+  EXPECT_FALSE(does_not_throw([&]{ YAMLStreamer streamer(YAML::Load("narrow_bad: {v: !int16 [1.5]}"),
+                                                          param_root_directory); }));
+}
+
 TEST(ClientTest, ClientUsage)
 {
   std::string what;
@@ -175,6 +309,589 @@ TEST(ClientTest, ClientUsage)
   std::cout << "What: " << what << std::endl;
 }
 
+TEST(ClientTest, SetNumbers)
+{
+  std::string what;
+
+  double d = 0.1, d_back = 0.0;
+  EXPECT_TRUE(cnr::param::set("/set_numbers/d", d, what));
+  EXPECT_TRUE(cnr::param::get("/set_numbers/d", d_back, what));
+  EXPECT_EQ(d, d_back);
+
+  std::vector<double> v = {1.0/3.0, -2.5e-300, 1e300, 4}, v_back;
+  EXPECT_TRUE(cnr::param::set("/set_numbers/v", v, what));
+  EXPECT_TRUE(cnr::param::get("/set_numbers/v", v_back, what));
+  EXPECT_EQ(v, v_back);
+
+  std::vector<std::vector<int>> vv = {{1, -2}, {3, 4}}, vv_back;
+  EXPECT_TRUE(cnr::param::set("/set_numbers/vv", vv, what));
+  EXPECT_TRUE(cnr::param::get("/set_numbers/vv", vv_back, what));
+  EXPECT_EQ(vv, vv_back);
+
+  Eigen::Vector3d e = Eigen::Vector3d::Random(), e_back;
+  EXPECT_TRUE(cnr::param::set("/set_numbers/e", e, what));
+  EXPECT_TRUE(cnr::param::get("/set_numbers/e", e_back, what));
+  EXPECT_EQ(e, e_back);
+
+  Eigen::MatrixXd m = Eigen::MatrixXd::Random(3, 4), m_back;
+  EXPECT_TRUE(cnr::param::set("/set_numbers/m", m, what));
+  EXPECT_TRUE(cnr::param::get("/set_numbers/m", m_back, what));
+  EXPECT_EQ(m, m_back);
+}
+
+TEST(ClientTest, SetEigenBinary)
+{
+  std::string what;
+
+  Eigen::MatrixXd big = Eigen::MatrixXd::Random(1000, 1000), big_back;
+  EXPECT_TRUE(cnr::param::set("/set_eigen/big", big, what));
+  EXPECT_TRUE(cnr::param::get("/set_eigen/big", big_back, what));
+  EXPECT_EQ(big, big_back);
+
+  Eigen::Matrix<double, 2, 3, Eigen::RowMajor> rm;
+  rm << 1, 2, 3, 4, 5, 6;
+  Eigen::Matrix<double, 2, 3> cm;
+  EXPECT_TRUE(cnr::param::set("/set_eigen/rm", rm, what));
+  EXPECT_TRUE(cnr::param::get("/set_eigen/rm", cm, what));
+  EXPECT_EQ(rm, cm);
+
+  std::vector<std::vector<double>> vv;
+  EXPECT_TRUE(cnr::param::get("/set_eigen/rm", vv, what));
+  EXPECT_EQ(vv, std::vector<std::vector<double>>({{1, 2, 3}, {4, 5, 6}}));
+
+  Eigen::Vector3f f(0.5f, 1.5f, -2.0f);
+  Eigen::Vector3d d;
+  EXPECT_TRUE(cnr::param::set("/set_eigen/f", f, what));
+  EXPECT_TRUE(cnr::param::get("/set_eigen/f", d, what));
+  EXPECT_EQ(f.cast<double>(), d);
+
+  Eigen::ArrayXd a = Eigen::ArrayXd::LinSpaced(5, 0.0, 1.0), a_back;
+  EXPECT_TRUE(cnr::param::set("/set_eigen/a", a, what));
+  EXPECT_TRUE(cnr::param::get("/set_eigen/a", a_back, what)) << what;
+  EXPECT_TRUE((a == a_back).all());
+  Eigen::ArrayXXd a2 = Eigen::ArrayXXd::Random(3, 4), a2_back;
+  EXPECT_TRUE(cnr::param::set("/set_eigen/a2", a2, what));
+  EXPECT_TRUE(cnr::param::get("/set_eigen/a2", a2_back, what)) << what;
+  EXPECT_TRUE((a2 == a2_back).all());
+  cnr::param::Snapshot snapshot;
+  a_back.resize(0);
+  EXPECT_TRUE(snapshot.get("/set_eigen/a", a_back, what)) << what;
+  EXPECT_TRUE((a == a_back).all());
+
+  Eigen::Matrix3d wrong_shape;
+  EXPECT_FALSE(cnr::param::get("/set_eigen/rm", wrong_shape, what));
+
+  // the lossy conversions are rejected, as by the std::vector
+  Eigen::VectorXd fractions(2);
+  fractions << 1.5, 2.7;
+  Eigen::VectorXi truncated;
+  std::vector<int> truncated_v;
+  EXPECT_TRUE(cnr::param::set("/set_eigen/fractions", fractions, what));
+  EXPECT_FALSE(cnr::param::get("/set_eigen/fractions", truncated, what));
+  EXPECT_FALSE(cnr::param::get("/set_eigen/fractions", truncated_v, what));
+
+  Eigen::Matrix<std::int64_t, 2, 1> wide(1, std::int64_t(1) << 40);
+  Eigen::Matrix<std::int32_t, 2, 1> narrow;
+  EXPECT_TRUE(cnr::param::set("/set_eigen/wide", wide, what));
+  EXPECT_FALSE(cnr::param::get("/set_eigen/wide", narrow, what));
+}
+
+struct PodGains
+{
+  double kp, ki, kd;
+  std::int32_t mode;
+};
+
+struct PodLimits
+{
+  double min, max, rate;
+  std::int32_t flags;
+};
+
+TEST(ClientTest, SetPod)
+{
+  std::string what;
+  cnr::param::param_error err;
+
+  PodGains gains{1.5, 0.25, 0.01, 3}, gains_back{};
+  EXPECT_TRUE(cnr::param::set_pod("/set_pod/gains", gains, what)) << what;
+  EXPECT_TRUE(cnr::param::get_pod("/set_pod/gains", gains_back, err)) << err.message();
+  EXPECT_EQ(std::memcmp(&gains, &gains_back, sizeof(PodGains)), 0);
+
+  gains.kp = 2.0;
+  EXPECT_TRUE(cnr::param::set_pod("/set_pod/gains", gains, what)) << what;
+  EXPECT_TRUE(cnr::param::get_pod("/set_pod/gains", gains_back, err)) << err.message();
+  EXPECT_EQ(gains_back.kp, 2.0);
+
+  // same size and alignment, another type: rejected, and the output is untouched
+  PodLimits limits{-1.0, 1.0, 0.5, 7};
+  EXPECT_FALSE(cnr::param::get_pod("/set_pod/gains", limits, err));
+  EXPECT_EQ(err.code, cnr::param::error_code_t::layout_mismatch);
+  EXPECT_EQ(limits.flags, 7);
+
+  EXPECT_TRUE(cnr::param::set("/set_pod/text", 1.0, what));
+  EXPECT_FALSE(cnr::param::get_pod("/set_pod/text", gains_back, err));
+  EXPECT_EQ(err.code, cnr::param::error_code_t::not_a_blob);
+
+  // the other readers get the bytes in base64
+  std::string encoded;
+  EXPECT_TRUE(cnr::param::get("/set_pod/gains", encoded, what)) << what;
+  EXPECT_EQ(YAML::DecodeBase64(encoded).size(), sizeof(PodGains));
+  YAML::Node ns;
+  EXPECT_TRUE(cnr::param::get("/set_pod", ns, what)) << what;
+  EXPECT_TRUE(ns["gains"].IsScalar());
+}
+
+TEST(ClientTest, Block)
+{
+  std::string what;
+  cnr::param::Block<PodGains> reader, writer;
+  PodGains gains{1.0, 0.0, 0.0, 1}, gains_back{};
+  boost::filesystem::remove(param_root_directory + "/block/gains.block");
+
+  EXPECT_FALSE(reader.open("/block/gains", what));
+  EXPECT_TRUE(writer.open("/block/gains", what, true)) << what;
+  EXPECT_TRUE(reader.open("/block/gains", what)) << what;
+  EXPECT_FALSE(reader.get(gains_back));
+  EXPECT_FALSE(reader.borrow());
+
+  cnr::param::Block<PodLimits> wrong;
+  EXPECT_FALSE(wrong.open("/block/gains", what));
+
+  EXPECT_TRUE(writer.set(gains, what)) << what;
+  EXPECT_TRUE(reader.get(gains_back));
+  EXPECT_EQ(gains_back.kp, 1.0);
+  EXPECT_EQ(reader.updates(), 1u);
+
+  // the borrowed buffers are not rewritten: the writer waits only if the readers hold both the back buffers
+  {
+    auto first = reader.borrow();
+    gains.kp = 2.0;
+    EXPECT_TRUE(writer.set(gains, what)) << what;
+    auto second = reader.borrow();
+    gains.kp = 3.0;
+    EXPECT_TRUE(writer.set(gains, what)) << what;
+    gains = PodGains{4.0, 4.0, 4.0, 4};
+    EXPECT_FALSE(writer.set(gains, what, std::chrono::milliseconds(1)));
+    EXPECT_EQ(first->kp, 1.0);
+    EXPECT_EQ(second->kp, 2.0);
+  }
+  EXPECT_TRUE(writer.set(gains, what)) << what;
+  EXPECT_TRUE(reader.get(gains_back));
+  EXPECT_EQ(gains_back.kp, 4.0);
+
+  // under a saturating writer, every read is a value written at once
+  std::atomic<bool> done(false);
+  std::thread saturate([&writer, &done]()
+  {
+    std::string err;
+    for(std::int32_t k = 0; k < 20000; k++)
+    {
+      PodGains g{double(k), double(k), double(k), k};
+      EXPECT_TRUE(writer.set(g, err)) << err;
+    }
+    done = true;
+  });
+
+  int torn = 0;
+  while(!done)
+  {
+    if(reader.get(gains_back))
+    {
+      torn += (gains_back.ki != gains_back.kp) || (gains_back.kd != gains_back.kp) || (gains_back.mode != gains_back.kp);
+    }
+  }
+  saturate.join();
+  EXPECT_EQ(torn, 0);
+
+  // a reader that dies while it pins a buffer leaks only that buffer
+  pid_t dead = fork();
+  if(dead == 0)
+  {
+    std::string err;
+    cnr::param::Block<PodGains> pinned;
+    pinned.open("/block/gains", err);
+    auto leaked = new cnr::param::Block<PodGains>::Borrowed(pinned.borrow());
+    static_cast<void>(leaked);
+    _exit(0);
+  }
+  ASSERT_GT(dead, 0);
+  waitpid(dead, nullptr, 0);
+  gains.kp = gains.ki = gains.kd = 5.0;
+  EXPECT_TRUE(writer.set(gains, what)) << what;
+  gains.kp = gains.ki = gains.kd = 6.0;
+  EXPECT_TRUE(writer.set(gains, what)) << what;
+
+  // the lock of a writer that died is taken over by the next writer
+  const std::string fn = param_root_directory + "/block/gains.block";
+  boost::interprocess::file_mapping file(fn.c_str(), boost::interprocess::read_write);
+  boost::interprocess::mapped_region region(file, boost::interprocess::read_write);
+  auto* header = static_cast<cnr::param::utils::block_header_t*>(region.get_address());
+  header->lock.store((std::uint64_t(1) << 32) | (std::uint64_t(dead) << 1) | 1);
+  gains.kp = gains.ki = gains.kd = 7.0;
+  EXPECT_TRUE(writer.set(gains, what)) << what;
+  EXPECT_TRUE(reader.get(gains_back));
+  EXPECT_EQ(gains_back.kp, 7.0);
+
+  // a writer that died while flipping the front, before counting the readers of the old one, does not leak it
+  {
+    auto pinned = reader.borrow();
+    const std::uint64_t word = header->front.load();
+    const std::uint32_t old_front = static_cast<std::uint32_t>(word >> 56);
+    std::uint32_t back = 0;
+    while(back == old_front || header->left[back].load() != header->entered[back].load())
+    {
+      back++;
+    }
+    ASSERT_LT(back, cnr::param::utils::block_buffers);
+    header->flip_entered = header->entered[old_front].load() + (word & ((std::uint64_t(1) << 56) - 1));
+    header->flip.store(word + 1);
+    header->front.store(std::uint64_t(back) << 56);
+    header->lock.store((std::uint64_t(2) << 32) | (std::uint64_t(dead) << 1) | 1);
+  }
+  for(double k : {8.0, 9.0})
+  {
+    gains.kp = gains.ki = gains.kd = k;
+    EXPECT_TRUE(writer.set(gains, what, std::chrono::milliseconds(100))) << what;
+  }
+  EXPECT_EQ(header->flip.load(), 0u);
+  EXPECT_TRUE(reader.get(gains_back));
+  EXPECT_EQ(gains_back.kp, 9.0);
+}
+
+TEST(ClientTest, SetInPlace)
+{
+  std::string what;
+  auto inode = [](const std::string& key)
+  {
+    struct stat st;
+    std::string fn = param_root_directory + key + ".yaml";
+    return stat(fn.c_str(), &st) == 0 ? st.st_ino : 0;
+  };
+
+  boost::filesystem::remove(param_root_directory + "/set_in_place/v.yaml");
+
+  std::vector<double> v(10, 1.0), v_back;
+  EXPECT_TRUE(cnr::param::set("/set_in_place/v", v, what));
+  auto first = inode("/set_in_place/v");
+  for(int i=0; i<100; i++)
+  {
+    v[0] = i;
+    EXPECT_TRUE(cnr::param::set("/set_in_place/v", v, what));
+  }
+  EXPECT_EQ(first, inode("/set_in_place/v"));
+  EXPECT_TRUE(cnr::param::get("/set_in_place/v", v_back, what));
+  EXPECT_EQ(v, v_back);
+
+  // it does not fit: the file is replaced by a bigger one
+  v.resize(1000, 2.0);
+  EXPECT_TRUE(cnr::param::set("/set_in_place/v", v, what));
+  EXPECT_NE(first, inode("/set_in_place/v"));
+  EXPECT_TRUE(cnr::param::get("/set_in_place/v", v_back, what));
+  EXPECT_EQ(v, v_back);
+
+  // smaller values reuse the bigger file
+  auto second = inode("/set_in_place/v");
+  v.resize(5);
+  EXPECT_TRUE(cnr::param::set("/set_in_place/v", v, what));
+  EXPECT_EQ(second, inode("/set_in_place/v"));
+  EXPECT_TRUE(cnr::param::get("/set_in_place/v", v_back, what));
+  EXPECT_EQ(v, v_back);
+  // the file replaced by another process: the mapping of the old file is not reused
+  std::string fn = param_root_directory + "/set_in_place/v.yaml";
+  boost::filesystem::copy_file(fn, fn + ".copy", boost::filesystem::copy_option::overwrite_if_exists);
+  boost::filesystem::rename(fn + ".copy", fn);
+  v[0] = 42.0;
+  EXPECT_TRUE(cnr::param::set("/set_in_place/v", v, what));
+  EXPECT_TRUE(cnr::param::get("/set_in_place/v", v_back, what));
+  EXPECT_EQ(v, v_back);
+}
+
+TEST(ClientTest, DeadWriter)
+{
+  namespace utils = cnr::param::utils;
+  std::string what;
+  pid_t dead = fork();
+  if(dead == 0)
+  {
+    _exit(0);
+  }
+  ASSERT_GT(dead, 0);
+  waitpid(dead, nullptr, 0);
+  const std::uint64_t dead_lock = (std::uint64_t(7) << 32) | (std::uint64_t(dead) << 1) | 1;
+
+  double v = 0;
+  EXPECT_TRUE(cnr::param::set("/dead_writer/v", 1.0, what));
+  EXPECT_TRUE(cnr::param::set("/dead_writer/v", 2.0, what));
+
+  // a writer died while it was rewriting the older slot in place
+  const std::string fn = param_root_directory + "/dead_writer/v.yaml";
+  boost::interprocess::file_mapping file(fn.c_str(), boost::interprocess::read_write);
+  boost::interprocess::mapped_region region(file, boost::interprocess::read_write);
+  auto* header = static_cast<utils::entry_header_t*>(region.get_address());
+  const int older = header->slots[0].generation < header->slots[1].generation ? 0 : 1;
+  header->writing = older + 1;
+  std::memset(static_cast<char*>(region.get_address()) + sizeof(utils::entry_header_t) + older * header->capacity, 'x',
+              header->slots[older].size);
+  header->seq.store(dead_lock);
+
+  // the readers do not wait, and they skip the slot, the next writer takes the lock over
+  EXPECT_TRUE(cnr::param::get("/dead_writer/v", v, what)) << what;
+  EXPECT_EQ(v, 2.0);
+  EXPECT_TRUE(cnr::param::set("/dead_writer/v", 3.0, what));
+  EXPECT_EQ(header->seq.load() & 1, 0u);
+  EXPECT_TRUE(cnr::param::get("/dead_writer/v", v, what)) << what;
+  EXPECT_EQ(v, 3.0);
+
+  // the same for the lock of the root directory
+  boost::interprocess::file_mapping gen_file((param_root_directory + "/.generation").c_str(),
+                                             boost::interprocess::read_write);
+  boost::interprocess::mapped_region gen_region(gen_file, boost::interprocess::read_write);
+  // the lock follows the magic and the version (see generation_header_t)
+  auto* gen_lock = reinterpret_cast<std::atomic<std::uint64_t>*>(static_cast<char*>(gen_region.get_address()) + 16);
+  gen_lock->store(dead_lock);
+  EXPECT_TRUE(cnr::param::set("/dead_writer/v", 4.0, what));
+  EXPECT_EQ(gen_lock->load() & 1, 0u);
+  EXPECT_TRUE(cnr::param::get("/dead_writer/v", v, what)) << what;
+  EXPECT_EQ(v, 4.0);
+}
+
+TEST(ClientTest, SetPatchesAncestors)
+{
+  std::string what;
+  YAML::Node node;
+
+  // the namespaces published by the server see the new value
+  std::string topic = "/patched_joint_states";
+  EXPECT_TRUE(cnr::param::set("/ns1/ns2/plan_hw/feedback_joint_state_topic", topic, what));
+  EXPECT_TRUE(cnr::param::get("/ns1/ns2/plan_hw", node, what));
+  EXPECT_EQ(node["feedback_joint_state_topic"].as<std::string>(), topic);
+  EXPECT_TRUE(cnr::param::get("/ns1", node, what));
+  EXPECT_EQ(node["ns2"]["plan_hw"]["feedback_joint_state_topic"].as<std::string>(), topic);
+
+  // the missing namespaces are created
+  boost::filesystem::remove_all(param_root_directory + "/set_patches");
+  boost::filesystem::remove(param_root_directory + "/set_patches.yaml");
+  boost::filesystem::remove(param_root_directory + "/set_patches.patches");
+
+  EXPECT_TRUE(cnr::param::set("/set_patches/a/b/gain", 1.0, what));
+  EXPECT_TRUE(cnr::param::set("/set_patches/a/c", std::string("x"), what));
+  EXPECT_TRUE(cnr::param::get("/set_patches", node, what));
+  EXPECT_EQ(node["a"]["b"]["gain"].as<double>(), 1.0);
+  EXPECT_EQ(node["a"]["c"].as<std::string>(), "x");
+
+  EXPECT_TRUE(cnr::param::set("/set_patches/a/b/gain", 2.0, what));
+  EXPECT_TRUE(cnr::param::get("/set_patches/a", node, what));
+  EXPECT_EQ(node["b"]["gain"].as<double>(), 2.0);
+  EXPECT_TRUE(cnr::param::get("/set_patches", node, what));
+  EXPECT_EQ(node["a"]["b"]["gain"].as<double>(), 2.0);
+
+  // writing a namespace replaces the descendants patched before
+  YAML::Node a;
+  a["d"] = 3;
+  EXPECT_TRUE(cnr::param::set("/set_patches/a", a, what));
+  EXPECT_TRUE(cnr::param::get("/set_patches/a", node, what));
+  EXPECT_FALSE(node["b"]);
+  EXPECT_EQ(node["d"].as<int>(), 3);
+  EXPECT_TRUE(cnr::param::get("/set_patches", node, what));
+  EXPECT_FALSE(node["a"]["b"]);
+  EXPECT_EQ(node["a"]["d"].as<int>(), 3);
+}
+
+TEST(ClientTest, Transaction)
+{
+  std::string what;
+  double p = 0, i = 0, d = 0;
+  EXPECT_TRUE(cnr::param::set("/transaction/pid/p", 0.0, what));
+  EXPECT_TRUE(cnr::param::set("/transaction/pid/i", 0.0, what));
+  EXPECT_TRUE(cnr::param::set("/transaction/pid/d", 0.0, what));
+
+  cnr::param::Transaction tr;
+  EXPECT_FALSE(tr.set("transaction/pid/p", 1.0, what));
+  EXPECT_TRUE(tr.set("/transaction/pid/p", 1.0, what));
+  EXPECT_TRUE(tr.set("/transaction/pid/i", 2.0, what));
+  EXPECT_TRUE(tr.set("/transaction/pid/d", 3.0, what));
+  EXPECT_EQ(tr.size(), 3u);
+
+  // nothing is visible before the commit
+  EXPECT_TRUE(cnr::param::get("/transaction/pid/p", p, what));
+  EXPECT_EQ(p, 0.0);
+
+  auto before = cnr::param::current_generation();
+  EXPECT_TRUE(tr.commit(what));
+  EXPECT_EQ(cnr::param::current_generation(), before + 1);
+  EXPECT_EQ(tr.size(), 0u);
+  EXPECT_TRUE(cnr::param::get("/transaction/pid/p", p, what));
+  EXPECT_TRUE(cnr::param::get("/transaction/pid/i", i, what));
+  EXPECT_TRUE(cnr::param::get("/transaction/pid/d", d, what));
+  EXPECT_EQ(p, 1.0);
+  EXPECT_EQ(i, 2.0);
+  EXPECT_EQ(d, 3.0);
+
+  // the readers of the namespace never see a half-applied transaction
+  EXPECT_TRUE(tr.set("/transaction/pid/p", -1.0, what));
+  EXPECT_TRUE(tr.set("/transaction/pid/i", -1.0, what));
+  EXPECT_TRUE(tr.set("/transaction/pid/d", -1.0, what));
+  EXPECT_TRUE(tr.commit(what));
+
+  std::atomic<bool> done(false);
+  std::thread writer([&done]()
+  {
+    std::string err;
+    for(int k = 0; k < 200; k++)
+    {
+      cnr::param::Transaction t;
+      t.set("/transaction/pid/p", double(k), err);
+      t.set("/transaction/pid/i", double(k), err);
+      t.set("/transaction/pid/d", double(k), err);
+      EXPECT_TRUE(t.commit(err));
+    }
+    done = true;
+  });
+
+  int mismatches = 0;
+  while(!done)
+  {
+    YAML::Node pid;
+    if(cnr::param::get("/transaction/pid", pid, what))
+    {
+      double _p = pid["p"].as<double>();
+      mismatches += (pid["i"].as<double>() != _p) || (pid["d"].as<double>() != _p);
+    }
+  }
+  writer.join();
+  EXPECT_EQ(mismatches, 0);
+
+  // the generation file is created again when it is removed, and the generations keep increasing
+  before = cnr::param::current_generation();
+  boost::filesystem::remove(param_root_directory + "/.generation");
+  EXPECT_TRUE(cnr::param::set("/transaction/pid/p", 5.0, what)) << what;
+  EXPECT_TRUE(boost::filesystem::exists(param_root_directory + "/.generation"));
+  EXPECT_GT(cnr::param::current_generation(), before + 1);
+  EXPECT_TRUE(cnr::param::get("/transaction/pid/p", p, what)) << what;
+  EXPECT_EQ(p, 5.0);
+}
+
+TEST(ClientTest, Snapshot)
+{
+  std::string what;
+  double q1 = 0, q2 = 0, q3 = 0;
+  Eigen::Vector3d m(1, 2, 3), m_back;
+  EXPECT_TRUE(cnr::param::set("/snapshot/q1", 1.0, what));
+  EXPECT_TRUE(cnr::param::set("/snapshot/q2", 1.0, what));
+  EXPECT_TRUE(cnr::param::set("/snapshot/q3", 1.0, what));
+  EXPECT_TRUE(cnr::param::set("/snapshot/m", m, what));
+
+  cnr::param::Snapshot snapshot;
+  EXPECT_TRUE(cnr::param::set("/snapshot/q1", 2.0, what));
+  EXPECT_TRUE(cnr::param::set("/snapshot/m", Eigen::Vector3d(4, 5, 6), what));
+
+  // the snapshot reads the values published before it was taken
+  EXPECT_TRUE(snapshot.get("/snapshot/q1", q1, what));
+  EXPECT_TRUE(snapshot.get("/snapshot/q2", q2, what));
+  EXPECT_TRUE(snapshot.get("/snapshot/m", m_back, what));
+  EXPECT_EQ(q1, 1.0);
+  EXPECT_EQ(q2, 1.0);
+  EXPECT_EQ(m_back, m);
+  YAML::Node ns;
+  EXPECT_TRUE(snapshot.get("/snapshot", ns, what));
+  EXPECT_EQ(ns["q1"].as<double>(), 1.0);
+  EXPECT_TRUE(cnr::param::get("/snapshot/q1", q1, what));
+  EXPECT_EQ(q1, 2.0);
+
+  // the values already read are cached
+  EXPECT_TRUE(cnr::param::set("/snapshot/q1", 3.0, what));
+  EXPECT_TRUE(cnr::param::set("/snapshot/q1", 4.0, what));
+  EXPECT_TRUE(snapshot.get("/snapshot/q1", q1, what));
+  EXPECT_EQ(q1, 1.0);
+
+  // a param updated twice after the snapshot is no more available
+  EXPECT_TRUE(cnr::param::set("/snapshot/q3", 2.0, what));
+  EXPECT_TRUE(cnr::param::set("/snapshot/q3", 3.0, what));
+  EXPECT_FALSE(snapshot.get("/snapshot/q3", q3, what));
+  snapshot.refresh();
+  EXPECT_TRUE(snapshot.get("/snapshot/q3", q3, what));
+  EXPECT_EQ(q3, 3.0);
+  EXPECT_TRUE(snapshot.get("/snapshot/q1", q1, what));
+  EXPECT_EQ(q1, 4.0);
+}
+
+#if defined(CNR_PARAM_ENABLE_STATS)
+TEST(ClientTest, Stats)
+{
+  namespace stats = cnr::param::utils::stats;
+  std::string what;
+  double q = 0;
+  EXPECT_TRUE(cnr::param::set("/stats/q", 1.0, what));
+  for(int i = 0; i < 10; i++)
+  {
+    EXPECT_TRUE(cnr::param::get("/stats/q", q, what));
+  }
+  EXPECT_FALSE(cnr::param::get("/stats/missing", q, what));
+
+  // the segment of the process is read as an external monitor does
+  const std::string path = stats::statsDirectory(std::getenv("CNR_PARAM_ROOT_DIRECTORY")) + "/"
+                          + std::to_string(getpid());
+  boost::interprocess::file_mapping file(path.c_str(), boost::interprocess::read_only);
+  boost::interprocess::mapped_region region(file, boost::interprocess::read_only);
+  ASSERT_TRUE(stats::validSegment(region.get_address(), region.get_size()));
+  const auto* segment = static_cast<const stats::stats_segment_t*>(region.get_address());
+  EXPECT_EQ(segment->pid, getpid());
+
+  std::uint64_t calls = 0, errors = 0, latencies = 0;
+  const std::size_t get = static_cast<std::size_t>(stats::op_t::get);
+  for(std::size_t t = 0; t < std::min<std::size_t>(segment->threads, stats::max_threads); t++)
+  {
+    calls += segment->thread[t].ops[get].calls;
+    errors += segment->thread[t].ops[get].errors;
+    for(const auto& h : segment->thread[t].ops[get].histogram)
+    {
+      latencies += h;
+    }
+  }
+  EXPECT_GE(calls, 11u);
+  EXPECT_GE(errors, 1u);
+  EXPECT_EQ(calls, latencies);
+
+  bool found = false;
+  for(const auto& k : segment->keys)
+  {
+    if(k.ready && std::string(k.key) == "/stats/q")
+    {
+      found = true;
+      EXPECT_EQ(k.calls[get], 10u);
+      EXPECT_EQ(k.errors[get], 0u);
+      EXPECT_EQ(k.calls[static_cast<std::size_t>(stats::op_t::set)], 1u);
+    }
+  }
+  EXPECT_TRUE(found);
+
+  // the segments of the dead processes are removed by the next process that creates its segment
+  pid_t dead = fork();
+  if(dead == 0)
+  {
+    _exit(0);
+  }
+  ASSERT_GT(dead, 0);
+  waitpid(dead, nullptr, 0);
+  const std::string stale = stats::statsDirectory(std::getenv("CNR_PARAM_ROOT_DIRECTORY")) + "/"
+                          + std::to_string(dead);
+  boost::filesystem::copy_file(path, stale, boost::filesystem::copy_option::overwrite_if_exists);
+
+  pid_t child = fork();
+  if(child == 0)
+  {
+    cnr::param::has("/stats/q", what);
+    _exit(0);
+  }
+  ASSERT_GT(child, 0);
+  waitpid(child, nullptr, 0);
+  EXPECT_FALSE(boost::filesystem::exists(stale));
+  boost::filesystem::remove(stats::statsDirectory(std::getenv("CNR_PARAM_ROOT_DIRECTORY")) + "/"
+                            + std::to_string(child));
+}
+#endif
+
 
 TEST(ClientErrorTest, ClientNonExistentParam)
 {
@@ -208,6 +925,102 @@ TEST(ClientErrorTest, ClientNonExistentParam)
 }
 
 
+TEST(ClientErrorTest, ErrorRecord)
+{
+  std::string what;
+  cnr::param::param_error err;
+  std::vector<double> v;
+  EXPECT_TRUE(cnr::param::set("/error_record/v", std::vector<std::string>{"1.0", "2.0", "not a number"}, what));
+
+  // the record tells what failed, without any message
+  EXPECT_FALSE(cnr::param::get("/error_record/v", v, err));
+  EXPECT_EQ(err.code, cnr::param::error_code_t::bad_conversion);
+  EXPECT_EQ(err.key, "/error_record/v");
+  ASSERT_EQ(err.depth, 1u);
+  EXPECT_EQ(err.index[0], 2u);
+  EXPECT_EQ(*err.type, typeid(double));
+  EXPECT_EQ(*err.requested, typeid(std::vector<double>));
+  EXPECT_TRUE(err.detail.empty());
+
+  // the message is rendered on request, and it is the one of the string API
+  const std::string message = err.message();
+  EXPECT_NE(message.find("/error_record/v"), std::string::npos) << message;
+  EXPECT_NE(message.find("[2]"), std::string::npos) << message;
+  EXPECT_FALSE(cnr::param::get("/error_record/v", v, what));
+  EXPECT_EQ(what, message);
+
+  std::vector<std::vector<double>> vv;
+  EXPECT_FALSE(cnr::param::get("/error_record/v", vv, err));
+  EXPECT_EQ(err.code, cnr::param::error_code_t::not_a_sequence);
+  EXPECT_EQ(err.index[0], 0u);
+
+  // beyond the max depth, the outermost indexes are dropped, and the path is marked as truncated
+  using deep_t = std::vector<std::vector<std::vector<std::vector<std::vector<double>>>>>;
+  auto deep = cnr::param::try_extract<deep_t>(YAML::Load("v: [[], [[[[1, 2, x]]]]]"), "v");
+  ASSERT_FALSE(deep);
+  EXPECT_EQ(deep.error().depth, cnr::param::param_error::max_depth);
+  EXPECT_TRUE(deep.error().truncated);
+  EXPECT_NE(deep.error().message().find("[...][0][0][0][2]"), std::string::npos) << deep.error().message();
+
+  // optional params
+  double d = 0;
+  EXPECT_FALSE(cnr::param::has("/error_record/missing", err));
+  EXPECT_EQ(err.code, cnr::param::error_code_t::missing_key);
+  EXPECT_FALSE(cnr::param::get("/error_record/missing", d, err));
+  EXPECT_EQ(err.code, cnr::param::error_code_t::missing_key);
+  EXPECT_TRUE(cnr::param::get("/error_record/missing", d, err, 3.0));
+  EXPECT_EQ(d, 3.0);
+  EXPECT_EQ(err.code, cnr::param::error_code_t::missing_key);
+}
+
+TEST(ClientErrorTest, Expected)
+{
+  std::string what;
+  EXPECT_TRUE(cnr::param::set("/expected/d", 2.5, what));
+  EXPECT_TRUE(cnr::param::set("/expected/s", std::string("not a number"), what));
+  EXPECT_TRUE(cnr::param::set("/expected/m", std::vector<std::vector<double>>{{1, 2}, {3}}, what));
+
+  auto d = cnr::param::try_get<double>("/expected/d");
+  ASSERT_TRUE(d);
+  EXPECT_EQ(*d, 2.5);
+
+  auto s = cnr::param::try_get<double>("/expected/s");
+  ASSERT_FALSE(s);
+  EXPECT_EQ(s.error().code, cnr::param::error_code_t::bad_conversion);
+  EXPECT_EQ(s.value_or(1.0), 1.0);
+  EXPECT_THROW(s.value(), std::runtime_error);
+
+  auto missing = cnr::param::try_get<std::vector<double>>("/expected/missing");
+  ASSERT_FALSE(missing);
+  EXPECT_EQ(missing.error().code, cnr::param::error_code_t::missing_key);
+  auto defaulted = cnr::param::try_get<double>("/expected/missing", 4.0);
+  ASSERT_TRUE(defaulted);
+  EXPECT_EQ(defaulted.value(), 4.0);
+
+  // the rows of a matrix must have the same size
+  auto m = cnr::param::try_get<Eigen::MatrixXd>("/expected/m");
+  ASSERT_FALSE(m);
+  EXPECT_EQ(m.error().code, cnr::param::error_code_t::size_mismatch);
+
+  cnr::param::node_t node = YAML::Load("{a: 1, b: [1, x]}");
+  auto a = cnr::param::try_extract<int>(node, "a");
+  ASSERT_TRUE(a);
+  EXPECT_EQ(*a, 1);
+  EXPECT_FALSE(cnr::param::try_extract<int>(node, "c"));
+  auto b = cnr::param::try_extract<std::vector<int>>(node, "b");
+  ASSERT_FALSE(b);
+  EXPECT_EQ(b.error().index[0], 1u);
+
+  // a key of a node that is not a map is an error, not an exception
+  cnr::param::expected<double> scalar_key(0.0);
+  EXPECT_NO_THROW(scalar_key = cnr::param::try_extract<double>(YAML::Load("42"), "missing"));
+  ASSERT_FALSE(scalar_key);
+  EXPECT_EQ(scalar_key.error().code, cnr::param::error_code_t::not_a_map);
+  auto sequence_key = cnr::param::try_extract<double>(YAML::Load("[1, 2]"), "missing");
+  ASSERT_FALSE(sequence_key);
+  EXPECT_EQ(sequence_key.error().code, cnr::param::error_code_t::not_a_map);
+}
+
 TEST(DeveloperTest, DeveloperFunctions)
 {
   std::string defval = "DEFAULT";
@@ -240,6 +1053,53 @@ TEST(DeveloperTest, DeveloperFunctions)
   EXPECT_TRUE(f1("/ns1/ns2/plan_hw/", "feedback_joint_state_topic"));
 }
 
+TEST(DeveloperTest, Logger)
+{
+  namespace log = cnr::param::utils::log;
+  std::mutex mutex;
+  std::vector<std::pair<log::level_t, std::string>> messages;
+  log::setSink([&](log::level_t level, const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    messages.emplace_back(level, message);
+  });
+  log::setLevel(log::level_t::warn);
+
+  CNR_PARAM_LOG_INFO("below the threshold");
+  CNR_PARAM_LOG_WARN("message " << 1);
+
+  // the producers do not wait for the sink: the messages that do not fit the buffer are dropped, and counted
+  const std::uint64_t dropped = log::dropped();
+  std::vector<std::thread> producers;
+  for(int t = 0; t < 2; t++)
+  {
+    producers.emplace_back([t]() {
+      for(int i = 0; i < 100; i++)
+      {
+        CNR_PARAM_LOG_ERROR("thread " << t << " message " << i);
+      }
+    });
+  }
+  for(auto& p : producers)
+  {
+    p.join();
+  }
+
+  log::flush();
+  log::setSink({});
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_FALSE(messages.empty());
+  EXPECT_EQ(messages.front().first, log::level_t::warn);
+  EXPECT_EQ(messages.front().second, "message 1");
+  std::size_t produced = 0;
+  for(const auto& m : messages)
+  {
+    EXPECT_NE(m.second, "below the threshold");
+    produced += m.second.find("thread ") == 0 ? 1 : 0;
+  }
+  EXPECT_EQ(produced + (log::dropped() - dropped), 200u);
+}
+
 TEST(DeveloperTest,GetVector)
 {
   std::string what;
@@ -390,6 +1250,430 @@ TEST(DeveloperTest,GetComplexType)
   }
 }
 
+struct Point2d
+{
+  double x;
+  double y;
+};
+
+namespace cnr { namespace param {
+  template<> struct decoder<Point2d>
+  {
+    static bool decode(const node_t& node, Point2d& ret, param_error& err)
+    {
+      std::array<double, 2> xy;
+      if(!node.IsSequence() || node.size() != 2 || !cnr::param::decode(node[0], xy[0], err)
+          || !cnr::param::decode(node[1], xy[1], err))
+      {
+        return err.fail(error_code_t::decoder, typeid(Point2d));
+      }
+      ret = Point2d{xy[0], xy[1]};
+      return true;
+    }
+  };
+}}
+
+TEST(DeveloperTest, DecoderSelection)
+{
+  using cnr::param::decoder_kind;
+  using cnr::param::decoder_kind_t;
+  static_assert(decoder_kind<float>::value == decoder_kind_t::arithmetic, "");
+  static_assert(decoder_kind<std::string>::value == decoder_kind_t::string, "");
+  static_assert(decoder_kind<std::vector<Point2d>>::value == decoder_kind_t::contiguous, "");
+  static_assert(decoder_kind<std::array<int, 3>>::value == decoder_kind_t::fixed_array, "");
+  static_assert(decoder_kind<Eigen::Vector3d>::value == decoder_kind_t::eigen_dense, "");
+  static_assert(decoder_kind<ComplexType>::value == decoder_kind_t::user, "");
+  static_assert(decoder_kind<int*>::value == decoder_kind_t::unsupported, "");
+
+  cnr::param::node_t node = YAML::Load("{f: 0.5, u: 7, vf: [1.5, 2], pts: [[0, 1], [2, 3]], bad: [[0, 1], [2]]}");
+  EXPECT_EQ(cnr::param::extract<float>(node, "f"), 0.5f);
+  EXPECT_EQ(cnr::param::extract<unsigned int>(node, "u"), 7u);
+  EXPECT_EQ(cnr::param::extract<std::vector<float>>(node, "vf"), std::vector<float>({1.5f, 2.0f}));
+
+  // the elements of the sequence are decoded by the registered decoder
+  auto pts = cnr::param::try_extract<std::vector<Point2d>>(node, "pts");
+  ASSERT_TRUE(pts);
+  ASSERT_EQ(pts->size(), 2u);
+  EXPECT_EQ(pts->at(1).x, 2.0);
+  EXPECT_EQ(pts->at(1).y, 3.0);
+
+  auto bad = cnr::param::try_extract<std::vector<Point2d>>(node, "bad");
+  ASSERT_FALSE(bad);
+  EXPECT_EQ(bad.error().code, cnr::param::error_code_t::decoder);
+  EXPECT_EQ(bad.error().index[0], 1u);
+}
+
+TEST(DeveloperTest, GetArray)
+{
+  std::string what;
+  std::vector<std::vector<double>> table(6, std::vector<double>(6, 0.0));
+  for(std::size_t i = 0; i < 6; i++)
+  {
+    table[i][i] = double(i);
+  }
+  ASSERT_TRUE(cnr::param::set("/array/table", table, what)) << what;
+  ASSERT_TRUE(cnr::param::set("/array/v", std::vector<int>{1, 2, 3}, what)) << what;
+
+  std::array<int, 3> v;
+  EXPECT_TRUE(cnr::param::get("/array/v", v, what)) << what;
+  EXPECT_EQ(v, (std::array<int, 3>{1, 2, 3}));
+
+  std::array<std::array<double, 6>, 6> t;
+  EXPECT_TRUE(cnr::param::get("/array/table", t, what)) << what;
+  EXPECT_EQ(t[5][5], 5.0);
+  EXPECT_EQ(t[5][4], 0.0);
+
+  auto short_array = cnr::param::try_get<std::array<int, 4>>("/array/v");
+  ASSERT_FALSE(short_array);
+  EXPECT_EQ(short_array.error().code, cnr::param::error_code_t::size_mismatch);
+  EXPECT_EQ(short_array.error().expected, 4u);
+  EXPECT_EQ(short_array.error().actual, 3u);
+
+  auto short_rows = cnr::param::try_get<std::array<std::array<double, 5>, 6>>("/array/table");
+  ASSERT_FALSE(short_rows);
+  EXPECT_EQ(short_rows.error().code, cnr::param::error_code_t::size_mismatch);
+  EXPECT_EQ(short_rows.error().index[0], 0u);
+}
+
+TEST(DeveloperTest, GetEigenFixed)
+{
+  cnr::param::node_t node = YAML::Load(
+    "{v: [1, 2, 3], m: [[1, 2], [3, 4]], m6: [[1, 0, 0, 0, 0, 0], [0, 1, 0, 0, 0, 0], [0, 0, 1, 0, 0, 0],"
+    " [0, 0, 0, 1, 0, 0], [0, 0, 0, 0, 1, 0], [0, 0, 0, 0, 0, 1]], r: [[1, 2], [3]], x: [1, 2.5]}");
+
+  auto v = cnr::param::try_extract<Eigen::Vector3i>(node, "v");
+  ASSERT_TRUE(v) << v.error().message();
+  EXPECT_EQ(*v, Eigen::Vector3i(1, 2, 3));
+
+  auto rv = cnr::param::try_extract<Eigen::RowVector3f>(node, "v");
+  ASSERT_TRUE(rv) << rv.error().message();
+  EXPECT_EQ(rv->y(), 2.0f);
+
+  auto m = cnr::param::try_extract<Eigen::Matrix2f>(node, "m");
+  ASSERT_TRUE(m) << m.error().message();
+  EXPECT_EQ((*m)(1, 0), 3.0f);
+
+  auto m6 = cnr::param::try_extract<Eigen::Matrix<double, 6, 6>>(node, "m6");
+  ASSERT_TRUE(m6) << m6.error().message();
+  EXPECT_EQ(*m6, (Eigen::Matrix<double, 6, 6>::Identity()));
+
+  // the shape of the node is checked against the sizes known at compile time
+  auto v4 = cnr::param::try_extract<Eigen::Vector4d>(node, "v");
+  ASSERT_FALSE(v4);
+  EXPECT_EQ(v4.error().code, cnr::param::error_code_t::size_mismatch);
+  EXPECT_EQ(v4.error().expected, 4u);
+  EXPECT_EQ(v4.error().actual, 3u);
+  EXPECT_FALSE((cnr::param::try_extract<Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 2, 1>>(node, "v")));
+  EXPECT_FALSE(cnr::param::try_extract<Eigen::Matrix3d>(node, "m"));
+
+  auto r = cnr::param::try_extract<Eigen::MatrixXd>(node, "r");
+  ASSERT_FALSE(r);
+  EXPECT_EQ(r.error().code, cnr::param::error_code_t::size_mismatch);
+  EXPECT_EQ(r.error().index[0], 1u);
+
+  auto x = cnr::param::try_extract<Eigen::Vector2i>(node, "x");
+  ASSERT_FALSE(x);
+  EXPECT_EQ(x.error().code, cnr::param::error_code_t::bad_conversion);
+  EXPECT_EQ(x.error().index[0], 1u);
+
+  // a Map cannot be resized: the memory after it is never written
+  std::array<double, 4> buffer = {0, 0, -1, -1};
+  Eigen::Map<Eigen::VectorXd> map(buffer.data(), 2);
+  cnr::param::param_error err;
+  EXPECT_FALSE(cnr::param::decode(node["v"], map, err));
+  EXPECT_EQ(err.code, cnr::param::error_code_t::size_mismatch);
+  EXPECT_EQ(buffer[2], -1.0);
+  Eigen::Map<Eigen::MatrixXd> map_m(buffer.data(), 1, 2);
+  EXPECT_FALSE(cnr::param::decode(node["m"], map_m, err));
+  EXPECT_EQ(err.code, cnr::param::error_code_t::size_mismatch);
+  EXPECT_EQ(buffer[2], -1.0);
+
+  // the views of the right size are written without being resized
+  Eigen::Map<Eigen::VectorXd> map_v(buffer.data(), 3);
+  EXPECT_TRUE(cnr::param::decode(node["v"], map_v, err)) << err.message();
+  EXPECT_EQ(buffer[3], -1.0);
+  Eigen::MatrixXd big = Eigen::MatrixXd::Zero(4, 4);
+  auto corner = big.topLeftCorner(2, 2);
+  EXPECT_TRUE(cnr::param::decode(node["m"], corner, err)) << err.message();
+  EXPECT_EQ(big(1, 0), 3.0);
+  EXPECT_EQ(big(2, 2), 0.0);
+  auto column = big.col(3);
+  EXPECT_FALSE(cnr::param::decode(node["v"], column, err));
+  EXPECT_EQ(err.code, cnr::param::error_code_t::size_mismatch);
+}
+
+TEST(DeveloperTest, GetTable)
+{
+  std::string what;
+  std::vector<std::vector<double>> vv(100, std::vector<double>(7));
+  for(std::size_t i = 0; i < vv.size(); i++)
+  {
+    for(std::size_t j = 0; j < vv[i].size(); j++)
+    {
+      vv[i][j] = double(i * 10 + j);
+    }
+  }
+  ASSERT_TRUE(cnr::param::set("/table/t", vv, what)) << what;
+
+  cnr::param::Matrix<double> t;
+  EXPECT_TRUE(cnr::param::get("/table/t", t, what)) << what;
+  ASSERT_EQ(t.rows(), 100u);
+  ASSERT_EQ(t.cols(), 7u);
+  EXPECT_EQ(t(42, 3), 423.0);
+  EXPECT_EQ(t.row(99)[6], 996.0);
+  EXPECT_EQ(t.data() + 7, t.row(1));
+  EXPECT_EQ(t.eigen()(12, 5), 125.0);
+
+  cnr::param::node_t node = YAML::Load("{i: [[1, 2], [3, 4]], r: [[1, 2], [3]], e: []}");
+  auto i = cnr::param::try_extract<cnr::param::Matrix<int>>(node, "i");
+  ASSERT_TRUE(i);
+  cnr::param::Matrix<int> expected(2, 2);
+  expected(0, 0) = 1;
+  expected(0, 1) = 2;
+  expected(1, 0) = 3;
+  expected(1, 1) = 4;
+  EXPECT_TRUE(*i == expected);
+
+  auto r = cnr::param::try_extract<cnr::param::Matrix<int>>(node, "r");
+  ASSERT_FALSE(r);
+  EXPECT_EQ(r.error().code, cnr::param::error_code_t::size_mismatch);
+  EXPECT_EQ(r.error().index[0], 1u);
+
+  auto e = cnr::param::try_extract<cnr::param::Matrix<float>>(node, "e");
+  ASSERT_TRUE(e);
+  EXPECT_TRUE(e->empty());
+}
+
+TEST(DeveloperTest, GetAssociative)
+{
+  static_assert(cnr::param::decoder_kind<cnr::param::flat_map<std::string, double>>::value
+                  == cnr::param::decoder_kind_t::associative, "");
+
+  std::string what;
+  YAML::Node limits = YAML::Load("{shoulder: [-3.1, 3.1], elbow: [-2.5, 2.5], wrist: [-1, 1]}");
+  ASSERT_TRUE(cnr::param::set("/associative/limits", limits, what)) << what;
+
+  std::map<std::string, std::vector<double>> m;
+  std::unordered_map<std::string, std::vector<double>> u;
+  cnr::param::flat_map<std::string, std::vector<double>> f;
+  EXPECT_TRUE(cnr::param::get("/associative/limits", m, what)) << what;
+  EXPECT_TRUE(cnr::param::get("/associative/limits", u, what)) << what;
+  EXPECT_TRUE(cnr::param::get("/associative/limits", f, what)) << what;
+  ASSERT_EQ(m.size(), 3u);
+  ASSERT_EQ(u.size(), 3u);
+  ASSERT_EQ(f.size(), 3u);
+  EXPECT_EQ(m["elbow"], std::vector<double>({-2.5, 2.5}));
+  EXPECT_EQ(u["wrist"], std::vector<double>({-1.0, 1.0}));
+  EXPECT_EQ(f.begin()->first, "elbow");
+  EXPECT_EQ(f.at("shoulder"), std::vector<double>({-3.1, 3.1}));
+
+  cnr::param::node_t node = YAML::Load("{ids: {1: a, 2: b}, bad: {a: 1, b: x}, seq: [1, 2]}");
+  auto ids = cnr::param::try_extract<std::map<int, std::string>>(node, "ids");
+  ASSERT_TRUE(ids);
+  EXPECT_EQ(ids->at(2), "b");
+
+  auto bad = cnr::param::try_extract<cnr::param::flat_map<std::string, double>>(node, "bad");
+  ASSERT_FALSE(bad);
+  EXPECT_EQ(bad.error().code, cnr::param::error_code_t::bad_conversion);
+  EXPECT_EQ(bad.error().index[0], 1u);
+  EXPECT_NE(bad.error().message().find("'b'"), std::string::npos);
+
+  auto seq = cnr::param::try_extract<std::unordered_map<std::string, double>>(node, "seq");
+  ASSERT_FALSE(seq);
+  EXPECT_EQ(seq.error().code, cnr::param::error_code_t::not_a_map);
+}
+
+struct BoundComplexType
+{
+  std::string name;
+  double value;
+};
+CNR_PARAM_BIND(BoundComplexType, CNR_PARAM_FIELD(name), CNR_PARAM_FIELD(value))
+
+struct BoundJoint
+{
+  std::string name;
+  double max_velocity;
+  std::vector<double> limits;
+  BoundComplexType gain;
+};
+CNR_PARAM_BIND(BoundJoint, CNR_PARAM_FIELD(name), CNR_PARAM_FIELD_KEY(max_velocity, "max_vel"),
+               CNR_PARAM_FIELD(limits), CNR_PARAM_FIELD(gain))
+
+TEST(DeveloperTest, BindStruct)
+{
+  std::string what;
+  std::vector<ComplexType> expected;
+  std::vector<BoundComplexType> vv;
+  EXPECT_TRUE(cnr::param::get("/n1/n4/test_vector_complex_type", expected, what));
+  EXPECT_TRUE(cnr::param::get("/n1/n4/test_vector_complex_type", vv, what)) << what;
+  ASSERT_EQ(vv.size(), expected.size());
+  for(std::size_t i = 0; i < vv.size(); i++)
+  {
+    EXPECT_EQ(vv[i].name, expected[i].name);
+    EXPECT_EQ(vv[i].value, expected[i].value);
+  }
+
+  cnr::param::node_t node = YAML::Load(
+    "{ok: {name: j1, max_vel: 2.5, limits: [-1, 1], gain: {name: p, value: 10}, unused: 0},"
+    " missing: {name: j2, limits: [], gain: {name: p, value: 1}},"
+    " bad: {name: j3, max_vel: 1, limits: [0, x], gain: {name: p, value: 1}}}");
+
+  auto ok = cnr::param::try_extract<BoundJoint>(node, "ok");
+  ASSERT_TRUE(ok) << ok.error().message();
+  EXPECT_EQ(ok->name, "j1");
+  EXPECT_EQ(ok->max_velocity, 2.5);
+  EXPECT_EQ(ok->limits, std::vector<double>({-1.0, 1.0}));
+  EXPECT_EQ(ok->gain.value, 10.0);
+
+  auto missing = cnr::param::try_extract<BoundJoint>(node, "missing");
+  ASSERT_FALSE(missing);
+  EXPECT_EQ(missing.error().code, cnr::param::error_code_t::missing_key);
+  EXPECT_NE(missing.error().message().find("max_vel"), std::string::npos);
+
+  auto bad = cnr::param::try_extract<BoundJoint>(node, "bad");
+  ASSERT_FALSE(bad);
+  EXPECT_EQ(bad.error().code, cnr::param::error_code_t::bad_conversion);
+  EXPECT_EQ(bad.error().index[0], 1u);
+  EXPECT_NE(bad.error().message().find("limits"), std::string::npos);
+
+  EXPECT_FALSE(cnr::param::try_extract<BoundJoint>(node["ok"], "limits"));
+
+  // the detail of a nested struct is kept
+  node = YAML::Load("{name: j4, max_vel: 1, limits: [], gain: {name: p}}");
+  auto nested = cnr::param::try_extract<BoundJoint>(node, "");
+  ASSERT_FALSE(nested);
+  EXPECT_NE(nested.error().message().find("In the field 'gain': The field 'value' is missing"), std::string::npos)
+    << nested.error().message();
+}
+
+// the perfect hash is found up to the 64 fields supported by CNR_PARAM_BIND
+constexpr std::array<const char*, 64> bound_keys = {{
+  "f00", "f01", "f02", "f03", "f04", "f05", "f06", "f07", "f08", "f09", "f10", "f11", "f12", "f13", "f14", "f15",
+  "f16", "f17", "f18", "f19", "f20", "f21", "f22", "f23", "f24", "f25", "f26", "f27", "f28", "f29", "f30", "f31",
+  "f32", "f33", "f34", "f35", "f36", "f37", "f38", "f39", "f40", "f41", "f42", "f43", "f44", "f45", "f46", "f47",
+  "f48", "f49", "f50", "f51", "f52", "f53", "f54", "f55", "f56", "f57", "f58", "f59", "f60", "f61", "f62", "f63"}};
+static_assert(cnr::param::_make_field_table<64>(bound_keys).seeded, "No seed for 64 keys");
+
+TEST(DeveloperTest, NumberParser)
+{
+  namespace utils = cnr::param::utils;
+  const utils::number_parser_t in_use = utils::numberParser();
+
+  // long sequences, so that the numbers cross the blocks of 64 bytes
+  std::string flow = "[";
+  std::string block = "\n";
+  for(int i = 0; i < 300; i++)
+  {
+    const std::string n = std::to_string(i * 7919 - 1000000) + (i % 3 ? ".125" : (i % 2 ? "e-3" : ""));
+    flow += (i ? ", " : "") + n;
+    block += "  - " + n + "\n";
+  }
+  flow += "]";
+
+  // the first texts are accepted, the others fall back to yaml-cpp ("010" is octal only for the integers)
+  const std::vector<std::string> accepted = {flow, block, "[[1, 2.5], [-3, 4e2]]", "\n- [1, 2]\n- [3, 4]\n",
+                                             "[+1, -0.5, .5, 5., 1E3, 0, 1234567890123456789, 010]", "[]"};
+  const std::vector<std::string> rejected = {"[0x10]", "[1, 2,]", "\n- 1 2\n", "[.inf]", "[1, [2]]",
+                                             "[[1, 2], [3]]", "\n- 1\n -2\n", "[1e400]", "[1, 2] 3", "[1]]", "[1] # c"};
+
+  auto yaml = [](const std::string& text, std::vector<double>& v, std::vector<std::vector<double>>& vv)
+  {
+    utils::setNumberParser(utils::number_parser_t::yaml);
+    try
+    {
+      cnr::param::node_t node = YAML::Load("v: " + text);
+      cnr::param::param_error err;
+      return std::make_pair(cnr::param::decode(node["v"], v, err), cnr::param::decode(node["v"], vv, err));
+    }
+    catch(std::exception&)
+    {
+      return std::make_pair(false, false);
+    }
+  };
+
+  for(auto parser : {utils::number_parser_t::portable, utils::number_parser_t::sse, utils::number_parser_t::avx2})
+  {
+    for(std::size_t t = 0; t < accepted.size() + rejected.size(); t++)
+    {
+      const std::string& text = t < accepted.size() ? accepted[t] : rejected[t - accepted.size()];
+      std::vector<double> v;
+      std::vector<std::vector<double>> vv;
+      const auto expected = yaml(text, v, vv);
+
+      if(!utils::setNumberParser(parser))
+      {
+        break;  // not supported by the CPU
+      }
+      std::vector<double> values;
+      utils::number_shape_t shape;
+      const bool ok = utils::parse_numbers(text.data(), text.data() + text.size(), values, shape);
+      EXPECT_EQ(ok, t < accepted.size()) << utils::to_string(parser) << ": " << text;
+      if(ok && !shape.nested)
+      {
+        EXPECT_TRUE(expected.first);
+        EXPECT_EQ(values, v) << utils::to_string(parser) << ": " << text;
+      }
+      else if(ok)
+      {
+        ASSERT_TRUE(expected.second);
+        ASSERT_EQ(shape.rows, vv.size());
+        for(std::size_t i = 0; i < vv.size(); i++)
+        {
+          EXPECT_EQ(std::vector<double>(values.begin() + i * shape.cols, values.begin() + (i + 1) * shape.cols), vv[i]);
+        }
+      }
+    }
+  }
+
+  utils::setNumberParser(utils::number_parser_t::portable);
+  const std::string big = "2147483648";
+  const std::string small = "-2147483648";
+  const std::string octal = "010";
+  int i = 0;
+  unsigned int u = 0;
+  EXPECT_FALSE(utils::parse_number(big.data(), big.data() + big.size(), i));
+  EXPECT_TRUE(utils::parse_number(small.data(), small.data() + small.size(), i));
+  EXPECT_EQ(i, std::numeric_limits<int>::min());
+  EXPECT_FALSE(utils::parse_number(octal.data(), octal.data() + octal.size(), i));
+  EXPECT_TRUE(utils::parse_number(big.data(), big.data() + big.size(), u));
+  EXPECT_FALSE(utils::parse_number(small.data(), small.data() + small.size(), u));
+
+  // the values read by the bulk parser are the same of yaml-cpp, and the errors are reported by the YAML path
+  std::string what;
+  std::vector<double> vd(5000);
+  for(std::size_t k = 0; k < vd.size(); k++)
+  {
+    vd[k] = std::sin(double(k)) * 1e3 / double(k + 1);
+  }
+  ASSERT_TRUE(cnr::param::set("/numbers/vd", vd, what)) << what;
+  std::vector<double> bulk;
+  std::vector<double> reference;
+  ASSERT_TRUE(utils::setNumberParser(utils::number_parser_t::portable));
+  EXPECT_TRUE(cnr::param::get("/numbers/vd", bulk, what)) << what;
+  ASSERT_TRUE(utils::setNumberParser(utils::number_parser_t::yaml));
+  EXPECT_TRUE(cnr::param::get("/numbers/vd", reference, what)) << what;
+  EXPECT_EQ(bulk, vd);
+  EXPECT_EQ(reference, vd);
+
+  utils::setNumberParser(in_use);
+  auto e = cnr::param::try_get<std::array<double, 3>>("/numbers/vd");
+  ASSERT_FALSE(e);
+  EXPECT_EQ(e.error().code, cnr::param::error_code_t::size_mismatch);
+
+  // a Map of another size is not written by the bulk path
+  std::array<double, 5> buffer = {0, 0, 0, -1, -1};
+  Eigen::Map<Eigen::VectorXd> map(buffer.data(), 3);
+  cnr::param::param_error err;
+  EXPECT_FALSE(cnr::param::get("/numbers/vd", map, err));
+  EXPECT_EQ(err.code, cnr::param::error_code_t::size_mismatch);
+  EXPECT_EQ(buffer[3], -1.0);
+  ASSERT_TRUE(cnr::param::set("/numbers/v3", std::vector<double>{1, 2, 3}, what)) << what;
+  EXPECT_TRUE(cnr::param::get("/numbers/v3", map, err)) << err.message();
+  EXPECT_EQ(buffer[2], 3.0);
+  EXPECT_EQ(buffer[3], -1.0);
+}
+
 int main(int argc, char **argv) {
 
   const char* env_p = std::getenv("CNR_PARAM_ROOT_DIRECTORY");